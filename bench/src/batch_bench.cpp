@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RxLite.hpp"
+
+// Compares adaptive batching with fixed batching across input rates.
+//
+// Values arrive as a Poisson process in virtual time and go to a simulated consumer that
+// pays a fixed cost per batch plus a cost per value, such as a syscall or a database round
+// trip. The consumer runs on the scheduler and is busy for the cost of each batch: the
+// values that arrive meanwhile are fed to the source from within its callback, so they
+// queue up behind it as they would behind a real worker. The fixed strategies hand their
+// batches to the consumer with `observeOn`. The latency of a value runs from its arrival
+// until the consumer has processed it, including the time it waited for the consumer.
+
+using namespace std::chrono_literals;
+
+using Duration = RxLite::Scheduler::Duration;
+using TimePoint = RxLite::Scheduler::TimePoint;
+
+constexpr std::size_t ValueCount = 200'000;
+constexpr Duration BatchCost = 5us;
+constexpr Duration ValueCost = 100ns;
+constexpr Duration MaxLatency = 1ms;
+constexpr std::size_t MaxSize = 64;
+
+struct Result {
+    double p99Microseconds;
+    double throughput;
+    double meanBatchSize;
+};
+
+// Moves the batches of a fixed strategy to the consumer on the scheduler
+RxLite::Operator<int, std::vector<int>> handOver(RxLite::Operator<int, std::vector<int>> batching, RxLite::Scheduler scheduler) {
+    return [batching, scheduler](RxLite::Observable<int> source) {
+        return source.pipe(batching).pipe(RxLite::observeOn<std::vector<int>>(scheduler));
+    };
+}
+
+Result benchmark(double rate, const std::function<RxLite::Operator<int, std::vector<int>>(RxLite::VirtualTimeScheduler&)>& makeOperator) {
+    RxLite::VirtualTimeScheduler scheduler;
+    RxLite::Subject<int> subject;
+
+    std::mt19937_64 random(42);
+    std::exponential_distribution<double> gapDistribution(rate);
+
+    std::vector<TimePoint> arrivals(ValueCount);
+    std::vector<Duration> latencies;
+    latencies.reserve(ValueCount);
+
+    TimePoint start = scheduler.now();
+    TimePoint arrival = start;
+    for (std::size_t i = 0; i < ValueCount; i++) {
+        arrival += std::chrono::duration_cast<Duration>(std::chrono::duration<double>(gapDistribution(random)));
+        arrivals[i] = arrival;
+    }
+
+    std::size_t fed = 0;
+    auto feedUntil = [&](TimePoint time) {
+        while (fed < ValueCount && arrivals[fed] <= time) {
+            subject.next(static_cast<int>(fed++));
+        }
+    };
+
+    TimePoint busyUntil;
+    std::size_t batches = 0;
+
+    RxLite::Subscription subscription = subject.pipe(makeOperator(scheduler)).subscribe([&](const std::vector<int>& batch) {
+        TimePoint begin = std::max(scheduler.now(), busyUntil);
+        busyUntil = begin + BatchCost + ValueCost * static_cast<Duration::rep>(batch.size());
+        batches++;
+
+        for (int index : batch) {
+            latencies.push_back(busyUntil - arrivals[index]);
+        }
+
+        // Values arriving while the consumer is busy
+        feedUntil(busyUntil);
+    });
+
+    while (fed < ValueCount) {
+        TimePoint next = arrivals[fed];
+        scheduler.advanceTo(next);
+        feedUntil(next);
+    }
+
+    // bufferTime reschedules itself forever, so run the clock just past the last deadline
+    scheduler.advanceBy(MaxLatency);
+    subject.complete();
+
+    std::sort(latencies.begin(), latencies.end());
+    Duration p99 = latencies[latencies.size() * 99 / 100];
+    double elapsed = std::chrono::duration<double>(busyUntil - start).count();
+
+    return {
+        std::chrono::duration<double, std::micro>(p99).count(),
+        static_cast<double>(latencies.size()) / elapsed,
+        static_cast<double>(latencies.size()) / static_cast<double>(batches)
+    };
+}
+
+int main() {
+    std::vector<std::pair<std::string, std::function<RxLite::Operator<int, std::vector<int>>(RxLite::VirtualTimeScheduler&)>>> strategies = {
+        { "bufferCount(1)", [](RxLite::VirtualTimeScheduler& scheduler) { return handOver(RxLite::bufferCount<int>(1), scheduler); } },
+        { "bufferCount(64)", [](RxLite::VirtualTimeScheduler& scheduler) { return handOver(RxLite::bufferCount<int>(MaxSize), scheduler); } },
+        { "bufferTime(1ms, 64)", [](RxLite::VirtualTimeScheduler& scheduler) { return handOver(RxLite::bufferTime<int>(MaxLatency, MaxSize, scheduler), scheduler); } },
+        { "adaptiveBatch(1ms, 64)", [](RxLite::VirtualTimeScheduler& scheduler) { return RxLite::adaptiveBatch<int>(MaxLatency, MaxSize, scheduler); } },
+    };
+
+    std::printf("%zu values per rate, consumer cost %lld ns per batch + %lld ns per value\n\n", ValueCount,
+                static_cast<long long>(std::chrono::nanoseconds(BatchCost).count()), static_cast<long long>(std::chrono::nanoseconds(ValueCost).count()));
+    std::printf("%-24s %12s %14s %16s %12s\n", "strategy", "rate/s", "p99 latency/us", "throughput/s", "mean batch");
+
+    for (double rate : { 1e3, 1e4, 1e5, 1e6, 4e6 }) {
+        for (const auto& [name, makeOperator] : strategies) {
+            Result result = benchmark(rate, makeOperator);
+            std::printf("%-24s %12.0f %14.1f %16.0f %12.1f\n", name.c_str(), rate, result.p99Microseconds, result.throughput, result.meanBatchSize);
+        }
+
+        std::printf("\n");
+    }
+
+    return 0;
+}
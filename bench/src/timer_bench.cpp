@@ -0,0 +1,118 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "RxLite.hpp"
+
+// Compares the timer backends on the workload of keyed debouncing and timeouts:
+// many pending timers that are scheduled, moved and cancelled far more often than they fire.
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+constexpr std::size_t TimerCount = 1'000'000;
+constexpr Clock::duration Horizon = 60s;
+constexpr Clock::duration Tick = 1ms;
+
+template <typename TimerQueue>
+void arm(TimerQueue& queue, const std::shared_ptr<RxLite::impl::TimerSlot>& slot, Clock::time_point due, Clock::time_point now) {
+    if (slot->armed) {
+        queue.remove(slot);
+    }
+
+    slot->generation++;
+    slot->due = due;
+    slot->armed = true;
+    queue.push(slot, now);
+}
+
+template <typename TimerQueue>
+void disarm(TimerQueue& queue, const std::shared_ptr<RxLite::impl::TimerSlot>& slot) {
+    if (slot->armed) {
+        queue.remove(slot);
+    }
+
+    slot->generation++;
+    slot->armed = false;
+}
+
+template <typename Func>
+double nanosecondsPer(std::size_t operations, Func&& func) {
+    auto start = Clock::now();
+    func();
+    auto elapsed = Clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / operations;
+}
+
+template <typename TimerQueue>
+void benchmark(const std::string& name, TimerQueue& queue) {
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<Clock::rep> dueDistribution(0, Horizon.count());
+
+    std::vector<std::shared_ptr<RxLite::impl::TimerSlot>> slots;
+    std::vector<Clock::time_point> dues;
+    for (std::size_t i = 0; i < TimerCount; i++) {
+        slots.push_back(std::make_shared<RxLite::impl::TimerSlot>([]() {}));
+        dues.push_back(Clock::time_point(Clock::duration(dueDistribution(random))));
+    }
+
+    Clock::time_point now;
+    std::size_t fired = 0;
+    std::vector<RxLite::impl::ExpiredTimer> expired;
+
+    double schedule = nanosecondsPer(TimerCount, [&]() {
+        for (std::size_t i = 0; i < TimerCount; i++) {
+            arm(queue, slots[i], dues[i], now);
+        }
+    });
+
+    // Debouncing moves every timer further into the future
+    double reschedule = nanosecondsPer(TimerCount, [&]() {
+        for (std::size_t i = 0; i < TimerCount; i++) {
+            arm(queue, slots[i], dues[i] + 1s, now);
+        }
+    });
+
+    double cancel = nanosecondsPer(TimerCount / 2, [&]() {
+        for (std::size_t i = 0; i < TimerCount; i += 2) {
+            disarm(queue, slots[i]);
+        }
+    });
+
+    std::size_t ticks = (Horizon + 2s) / Tick;
+    double expire = nanosecondsPer(ticks, [&]() {
+        for (std::size_t tick = 0; tick < ticks; tick++) {
+            now += Tick;
+            queue.expire(now, expired);
+
+            for (const auto& timer : expired) {
+                if (timer.generation == timer.slot->generation && timer.slot->armed) {
+                    timer.slot->armed = false;
+                    fired++;
+                }
+            }
+
+            expired.clear();
+        }
+    });
+
+    std::printf("%-16s %12.1f %12.1f %12.1f %14.1f %10zu\n", name.c_str(), schedule, reschedule, cancel, expire, fired);
+}
+
+int main() {
+    std::printf("%zu timers over %lld s, 1 ms ticks\n\n", TimerCount, static_cast<long long>(Horizon / 1s));
+    std::printf("%-16s %12s %12s %12s %14s %10s\n", "backend", "schedule/ns", "resched/ns", "cancel/ns", "expire/tick ns", "fired");
+
+    {
+        RxLite::HeapTimerQueue heap;
+        benchmark("HeapTimerQueue", heap);
+    }
+
+    {
+        RxLite::TimerWheel wheel(Tick);
+        benchmark("TimerWheel", wheel);
+    }
+
+    return 0;
+}
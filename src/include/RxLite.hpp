@@ -1,6 +1,22 @@
 #pragma once
 
+#include "coroutine.hpp"
+#include "execution.hpp"
 #include "operator.hpp"
 
+#include "flowable/backpressure.hpp"
+#include "flowable/flowable.hpp"
+#include "flowable/operator.hpp"
+
 #include "subject/behavior_subject.hpp"
 #include "subject/replay_subject.hpp"
+
+#include "scheduler/affinity.hpp"
+#include "scheduler/event_loop_scheduler.hpp"
+#include "scheduler/test_scheduler.hpp"
+#include "scheduler/timer_wheel.hpp"
+#include "scheduler/trampoline_scheduler.hpp"
+
+#if defined(__linux__)
+#include "io/reactor.hpp"
+#endif
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace RxLite {
+
+/**
+ * @brief A pool of vectors for the batches emitted by the buffer operators.
+ *
+ * The buffer operators (`bufferCount`, `bufferTime`, `bufferWhen`) take the storage of each
+ * batch from a pool and return it once the batch was emitted, so after warming up buffering
+ * allocates nothing. A batch is only valid until `next` returns. Consumers that need to keep
+ * one copy it into a vector from `acquire()` of the same pool and hand that back with
+ * `recycle()` once they are done, which keeps their copies allocation-free as well.
+ *
+ * Copies of a `BatchPool` share the same vectors. The pool is thread-safe.
+ *
+ * @tparam T The type of values in the batches.
+ */
+template <typename T>
+class BatchPool {
+public:
+    /**
+     * @brief The number of vectors a pool keeps by default.
+     */
+    static constexpr std::size_t DefaultMaxPooled = 16;
+
+    /**
+     * @brief Constructs an empty pool.
+     *
+     * @param maxPooled The maximum number of vectors kept for reuse; further vectors are freed.
+     */
+    explicit BatchPool(std::size_t maxPooled = DefaultMaxPooled) : context(std::make_shared<Context>(maxPooled)) {}
+
+    /**
+     * @brief Takes an empty vector from the pool, or creates one if the pool is empty.
+     *
+     * @param capacity The number of values the vector must hold without reallocating.
+     * @return std::vector<T> An empty vector with at least the given capacity.
+     */
+    std::vector<T> acquire(std::size_t capacity = 0) const {
+        std::vector<T> batch;
+
+        {
+            std::unique_lock lock(context->mutex);
+            if (!context->batches.empty()) {
+                batch = std::move(context->batches.back());
+                context->batches.pop_back();
+            }
+        }
+
+        batch.reserve(capacity);
+        return batch;
+    }
+
+    /**
+     * @brief Hands a vector back for reuse.
+     *
+     * The vector is cleared; its storage is kept unless the pool is full.
+     *
+     * @param batch The vector to recycle.
+     */
+    void recycle(std::vector<T>&& batch) const {
+        if (batch.capacity() == 0) {
+            return;
+        }
+
+        batch.clear();
+
+        std::unique_lock lock(context->mutex);
+        if (context->batches.size() < context->maxPooled) {
+            context->batches.push_back(std::move(batch));
+        }
+    }
+
+    /**
+     * @brief Returns the number of vectors waiting for reuse.
+     */
+    std::size_t size() const {
+        std::unique_lock lock(context->mutex);
+        return context->batches.size();
+    }
+
+private:
+    struct Context {
+        const std::size_t maxPooled;
+        std::mutex mutex;
+        std::vector<std::vector<T>> batches;
+
+        explicit Context(std::size_t maxPooled) : maxPooled(maxPooled) {
+            batches.reserve(maxPooled);
+        }
+    };
+
+    std::shared_ptr<Context> context;
+};
+
+} // namespace RxLite
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+namespace RxLite {
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// A split-block Bloom filter.
+//
+// The filter is an array of 256-bit blocks, each aligned so it never straddles a cache line.
+// An item only touches the one block selected by the upper half of its hash; within it, the
+// lower half is multiplied by eight odd constants to pick one bit in each of the block's
+// eight 32-bit words. An insert, which doubles as the lookup, therefore costs a single
+// cache miss, and the eight lanes of fixed-width arithmetic are vectorized by the compiler.
+// The size is fixed up front from the expected number of items and the acceptable false
+// positive rate.
+class BlockedBloomFilter {
+public:
+    static constexpr std::size_t BlockBits = 256;
+
+    BlockedBloomFilter(std::size_t expectedItems, double falsePositiveRate) {
+        validate(expectedItems, falsePositiveRate);
+
+        // With one bit set per word, a lookup is a false positive if eight words all have the bit set
+        double bits = -8.0 * static_cast<double>(expectedItems) / std::log(1.0 - std::pow(falsePositiveRate, 1.0 / 8));
+        blocks.resize(std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(bits / BlockBits))));
+    }
+
+    // Throws unless a filter can be sized for these arguments
+    static void validate(std::size_t expectedItems, double falsePositiveRate) {
+        if (expectedItems == 0 || !(falsePositiveRate > 0 && falsePositiveRate < 1)) {
+            throw std::invalid_argument("BlockedBloomFilter: expected items must be positive and the false positive rate in (0, 1)");
+        }
+    }
+
+    // Adds the item; returns the number of bits it newly set, so `0` means it was probably present
+    std::size_t insert(std::uint64_t hash) {
+        Block& block = blocks[blockIndex(hash)];
+        std::array<std::uint32_t, 8> mask = maskOf(hash);
+
+        std::size_t newlySet = 0;
+        for (std::size_t i = 0; i < 8; i++) {
+            newlySet += static_cast<std::size_t>(std::popcount(mask[i] & ~block.words[i]));
+            block.words[i] |= mask[i];
+        }
+
+        return newlySet;
+    }
+
+    std::size_t bitCount() const {
+        return blocks.size() * BlockBits;
+    }
+
+private:
+    struct alignas(32) Block {
+        std::array<std::uint32_t, 8> words{};
+    };
+
+    std::vector<Block> blocks;
+
+    // Maps the upper half of the hash onto the blocks without a division
+    std::size_t blockIndex(std::uint64_t hash) const {
+        return static_cast<std::size_t>(((hash >> 32) * blocks.size()) >> 32);
+    }
+
+    static std::array<std::uint32_t, 8> maskOf(std::uint64_t hash) {
+        static constexpr std::array<std::uint32_t, 8> Salts = {
+            0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+            0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+        };
+
+        std::array<std::uint32_t, 8> mask;
+        for (std::size_t i = 0; i < 8; i++) {
+            mask[i] = 1u << ((static_cast<std::uint32_t>(hash) * Salts[i]) >> 27);
+        }
+
+        return mask;
+    }
+};
+
+} // namespace impl
+
+} // namespace RxLite
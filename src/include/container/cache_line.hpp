@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace RxLite {
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// Data written by different threads is aligned to this, so the threads do not share a cache line
+inline constexpr std::size_t CacheLineSize = 64;
+
+} // namespace impl
+
+} // namespace RxLite
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+
+namespace RxLite {
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// An open-addressing hash map that stores its entries densely, in insertion order.
+//
+// Entries live in one vector; the hash table only holds 32-bit indices into it, probed
+// linearly, so lookups touch one small array and iteration is a linear scan. Erasing moves
+// the last entry into the gap (which breaks insertion order) and closes the gap in the
+// table by shifting entries back instead of leaving tombstones. `clear()` keeps all storage,
+// so a map that is refilled to the same size does not allocate. An empty value type takes
+// no space in the entries, so such a map doubles as a set as compact as its keys.
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class FlatHashMap {
+public:
+    // Named like `std::pair` so entries destructure the same way
+    struct value_type {
+        K first;
+        [[no_unique_address]] V second;
+
+        template <typename... Args>
+        explicit value_type(const K& key, Args&&... args) : first(key), second(std::forward<Args>(args)...) {}
+    };
+
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    explicit FlatHashMap(std::size_t capacity = 0, Hash hash = Hash(), KeyEqual equal = KeyEqual())
+        : hash(std::move(hash)), equal(std::move(equal)) {
+        reserve(capacity);
+    }
+
+    std::size_t size() const {
+        return entries.size();
+    }
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+    iterator begin() {
+        return entries.begin();
+    }
+
+    iterator end() {
+        return entries.end();
+    }
+
+    const_iterator begin() const {
+        return entries.begin();
+    }
+
+    const_iterator end() const {
+        return entries.end();
+    }
+
+    // Makes room for `capacity` entries without rehashing
+    void reserve(std::size_t capacity) {
+        entries.reserve(capacity);
+
+        std::size_t slots = std::bit_ceil(std::max<std::size_t>(capacity * 2, 8));
+        if (slots > table.size()) {
+            rehash(slots);
+        }
+    }
+
+    V* find(const K& key) {
+        std::size_t slot = findSlot(key);
+        return table[slot] == Empty ? nullptr : &entries[table[slot] - 1].second;
+    }
+
+    const V* find(const K& key) const {
+        return const_cast<FlatHashMap*>(this)->find(key);
+    }
+
+    bool contains(const K& key) const {
+        return find(key) != nullptr;
+    }
+
+    // Inserts the entry unless the key is present; returns the value and whether it was inserted
+    template <typename... Args>
+    std::pair<V*, bool> tryEmplace(const K& key, Args&&... args) {
+        if ((entries.size() + 1) * 2 > table.size()) {
+            rehash(table.size() * 2);
+        }
+
+        std::size_t slot = findSlot(key);
+        if (table[slot] != Empty) {
+            return { &entries[table[slot] - 1].second, false };
+        }
+
+        entries.emplace_back(key, std::forward<Args>(args)...);
+        table[slot] = static_cast<std::uint32_t>(entries.size());
+        return { &entries.back().second, true };
+    }
+
+    // Inserts the entry or replaces the value of a present key, keeping its position
+    template <typename Value>
+    bool insertOrAssign(const K& key, Value&& value) {
+        auto [slot, inserted] = tryEmplace(key, std::forward<Value>(value));
+        if (!inserted) {
+            *slot = std::forward<Value>(value);
+        }
+
+        return inserted;
+    }
+
+    bool erase(const K& key) {
+        std::size_t slot = findSlot(key);
+        if (table[slot] == Empty) {
+            return false;
+        }
+
+        std::uint32_t entry = table[slot] - 1;
+        removeSlot(slot);
+
+        // Move the last entry into the gap and point its slot at the new position
+        std::uint32_t last = static_cast<std::uint32_t>(entries.size() - 1);
+        if (entry != last) {
+            table[findSlot(entries[last].first)] = entry + 1;
+            entries[entry] = std::move(entries[last]);
+        }
+
+        entries.pop_back();
+        return true;
+    }
+
+    void clear() {
+        if (!entries.empty()) {
+            std::fill(table.begin(), table.end(), Empty);
+            entries.clear();
+        }
+    }
+
+    void swap(FlatHashMap& other) noexcept {
+        std::swap(entries, other.entries);
+        std::swap(table, other.table);
+        std::swap(shift, other.shift);
+        std::swap(hash, other.hash);
+        std::swap(equal, other.equal);
+    }
+
+private:
+    static constexpr std::uint32_t Empty = 0;
+
+    std::vector<value_type> entries;
+    std::vector<std::uint32_t> table; // Entry index + 1, or Empty
+    int shift = 64;
+    Hash hash;
+    KeyEqual equal;
+
+    // Fibonacci hashing spreads poor hashes, such as the identity hash of integers
+    std::size_t home(const K& key) const {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(hash(key)) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    // Returns the slot holding the key, or the empty slot where it belongs
+    std::size_t findSlot(const K& key) const {
+        std::size_t mask = table.size() - 1;
+
+        for (std::size_t slot = home(key);; slot = (slot + 1) & mask) {
+            if (table[slot] == Empty || equal(entries[table[slot] - 1].first, key)) {
+                return slot;
+            }
+        }
+    }
+
+    // Backward-shift deletion: pulls later entries of the probe sequence into the gap
+    void removeSlot(std::size_t gap) {
+        std::size_t mask = table.size() - 1;
+
+        for (std::size_t slot = (gap + 1) & mask; table[slot] != Empty; slot = (slot + 1) & mask) {
+            std::size_t desired = home(entries[table[slot] - 1].first);
+            if (((slot - desired) & mask) >= ((slot - gap) & mask)) {
+                table[gap] = table[slot];
+                gap = slot;
+            }
+        }
+
+        table[gap] = Empty;
+    }
+
+    void rehash(std::size_t slots) {
+        table.assign(slots, Empty);
+        shift = 64 - std::countr_zero(slots);
+
+        for (std::size_t i = 0; i < entries.size(); i++) {
+            table[findSlot(entries[i].first)] = static_cast<std::uint32_t>(i + 1);
+        }
+    }
+};
+
+} // namespace impl
+
+} // namespace RxLite
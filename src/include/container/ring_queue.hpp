@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+namespace RxLite {
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// A FIFO queue in a ring buffer that doubles in size when full.
+//
+// Unlike `std::deque`, whose blocks are allocated and freed as the queue moves along, the
+// ring keeps its storage, so a queue that stays within its largest size never allocates.
+// Not thread-safe.
+template <typename T>
+class RingQueue {
+public:
+    explicit RingQueue(std::size_t capacity = 0) {
+        if (capacity > 0) {
+            slots.resize(std::bit_ceil(capacity));
+        }
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void push(T value) {
+        if (count == slots.size()) {
+            grow();
+        }
+
+        slots[(head + count) & (slots.size() - 1)].emplace(std::move(value));
+        count++;
+    }
+
+    // Must not be called on an empty queue
+    T pop() {
+        std::optional<T>& slot = slots[head];
+        T value = std::move(*slot);
+        slot.reset();
+
+        head = (head + 1) & (slots.size() - 1);
+        count--;
+        return value;
+    }
+
+    void clear() {
+        while (!empty()) {
+            pop();
+        }
+    }
+
+private:
+    std::vector<std::optional<T>> slots;
+    std::size_t head = 0;
+    std::size_t count = 0;
+
+    void grow() {
+        std::vector<std::optional<T>> grown(std::max<std::size_t>(slots.size() * 2, 8));
+        for (std::size_t i = 0; i < count; i++) {
+            grown[i] = std::move(slots[(head + i) & (slots.size() - 1)]);
+        }
+
+        slots = std::move(grown);
+        head = 0;
+    }
+};
+
+} // namespace impl
+
+} // namespace RxLite
@@ -0,0 +1,469 @@
+#pragma once
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "observable.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief The return type of coroutines that produce the values of an Observable.
+ *
+ * An `AsyncGenerator<T>` coroutine emits values with `co_yield`, completes with `co_return`
+ * and errors by throwing. It may `co_await` other work in between, such as `first()` or
+ * `toVector()` of other observables, in which case it is suspended until that work is done
+ * and resumed on the thread that finished it. Pass the coroutine to `Observable<T>::create()`
+ * to turn it into an observable; each subscription runs a fresh coroutine.
+ *
+ * A generator stops at its next `co_yield` once its subscriber has unsubscribed, and its frame
+ * is destroyed. Unsubscribing while the generator is suspended destroys the frame immediately.
+ *
+ * Coroutine frames are recycled through a per-thread pool instead of being allocated on the
+ * heap every time. A coroutine whose first two parameters are `std::allocator_arg_t` and an
+ * allocator allocates its frame with that allocator instead.
+ *
+ * @tparam T The type of values yielded by the coroutine.
+ */
+template <typename T>
+class AsyncGenerator;
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+class FrameAllocation {
+public:
+    static void* operator new(std::size_t size) {
+        void* block = pool().allocate(HeaderSize + size);
+        return initialize(block, &deallocatePooled);
+    }
+
+    // The allocator overloads inline into the coroutine, and the allocation itself stays out of
+    // line: g++ otherwise pairs a templated or the allocator's own `operator new` with the sized
+    // delete below and warns about a mismatch, while the frame header decides how to release it
+    template <typename Alloc, typename... Args>
+    [[gnu::always_inline]] static void* operator new(std::size_t size, std::allocator_arg_t, const Alloc& alloc, const Args&...) {
+        return allocateWith(size, alloc);
+    }
+
+    template <typename Self, typename Alloc, typename... Args>
+    [[gnu::always_inline]] static void* operator new(std::size_t size, Self&, std::allocator_arg_t, const Alloc& alloc, const Args&... args) {
+        // Member function coroutines receive the object as their first argument
+        return operator new(size, std::allocator_arg, alloc, args...);
+    }
+
+    static void operator delete(void* frame, std::size_t size) {
+        void* block = static_cast<std::byte*>(frame) - HeaderSize;
+        (*static_cast<Deallocate*>(block))(block, size);
+    }
+
+private:
+    using Deallocate = void (*)(void* block, std::size_t frameSize);
+
+    static constexpr std::size_t HeaderSize = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    static constexpr std::size_t SizeClass = 64;
+    static constexpr std::size_t SizeClasses = 16;
+    static constexpr std::size_t MaxPooledPerClass = 64;
+
+    class Pool {
+    public:
+        ~Pool() {
+            for (FreeBlock*& list : freeLists) {
+                while (list) {
+                    FreeBlock* next = list->next;
+                    ::operator delete(list);
+                    list = next;
+                }
+            }
+        }
+
+        void* allocate(std::size_t bytes) {
+            std::size_t index = classOf(bytes);
+            if (index >= SizeClasses) {
+                return ::operator new(bytes);
+            }
+
+            if (FreeBlock* block = freeLists[index]) {
+                freeLists[index] = block->next;
+                counts[index]--;
+                return block;
+            }
+
+            return ::operator new((index + 1) * SizeClass);
+        }
+
+        void deallocate(void* pointer, std::size_t bytes) {
+            std::size_t index = classOf(bytes);
+            if (index >= SizeClasses || counts[index] == MaxPooledPerClass) {
+                ::operator delete(pointer);
+                return;
+            }
+
+            FreeBlock* block = static_cast<FreeBlock*>(pointer);
+            block->next = freeLists[index];
+            freeLists[index] = block;
+            counts[index]++;
+        }
+
+    private:
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        std::array<FreeBlock*, SizeClasses> freeLists{};
+        std::array<std::size_t, SizeClasses> counts{};
+
+        static std::size_t classOf(std::size_t bytes) {
+            return (bytes - 1) / SizeClass;
+        }
+    };
+
+    static Pool& pool() {
+        thread_local Pool pool;
+        return pool;
+    }
+
+    static void* initialize(void* block, Deallocate deallocate) {
+        new (block) Deallocate(deallocate);
+        return static_cast<std::byte*>(block) + HeaderSize;
+    }
+
+    static constexpr std::size_t allocatorOffset(std::size_t frameSize) {
+        std::size_t end = HeaderSize + frameSize;
+        return (end + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    }
+
+    static void deallocatePooled(void* block, std::size_t frameSize) {
+        pool().deallocate(block, HeaderSize + frameSize);
+    }
+
+    template <typename Alloc>
+    [[gnu::noinline]] static void* allocateWith(std::size_t frameSize, const Alloc& alloc) {
+        using ByteAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::byte>;
+
+        ByteAlloc byteAlloc(alloc);
+        std::byte* block = std::allocator_traits<ByteAlloc>::allocate(byteAlloc, allocatorOffset(frameSize) + sizeof(ByteAlloc));
+        new (block + allocatorOffset(frameSize)) ByteAlloc(std::move(byteAlloc));
+        return initialize(block, &deallocateWith<ByteAlloc>);
+    }
+
+    template <typename ByteAlloc>
+    static void deallocateWith(void* block, std::size_t frameSize) {
+        std::byte* bytes = static_cast<std::byte*>(block);
+        ByteAlloc* stored = reinterpret_cast<ByteAlloc*>(bytes + allocatorOffset(frameSize));
+        ByteAlloc byteAlloc(std::move(*stored));
+        stored->~ByteAlloc();
+        std::allocator_traits<ByteAlloc>::deallocate(byteAlloc, bytes, allocatorOffset(frameSize) + sizeof(ByteAlloc));
+    }
+};
+
+// Serializes resumption and cancellation of a coroutine that is shared between its
+// subscription and the awaitables it is suspended on.
+class CoroutineDriver {
+public:
+    explicit CoroutineDriver(std::coroutine_handle<> handle) : handle(handle) {}
+
+    void resume() {
+        std::unique_lock lock(mutex);
+        if (running) {
+            // Resumed from a callback while the coroutine is still returning from `resume()`
+            pending = true;
+            return;
+        }
+
+        running = true;
+        do {
+            pending = false;
+            if (cancelled || !handle || handle.done()) {
+                break;
+            }
+
+            lock.unlock();
+            handle.resume();
+            lock.lock();
+        } while (pending);
+
+        running = false;
+        if (handle && (handle.done() || cancelled)) {
+            std::exchange(handle, nullptr).destroy();
+        }
+    }
+
+    void cancel() {
+        std::unique_lock lock(mutex);
+        cancelled = true;
+
+        if (!running && handle) {
+            std::exchange(handle, nullptr).destroy();
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::coroutine_handle<> handle;
+    bool running = false;
+    bool pending = false;
+    bool cancelled = false;
+};
+
+// Resumes an awaiting coroutine, through its driver if it is an AsyncGenerator
+class Resumer {
+public:
+    Resumer() = default;
+
+    template <typename Promise>
+    explicit Resumer(std::coroutine_handle<Promise> handle) : handle(handle) {
+        if constexpr (requires { handle.promise().weakDriver; }) {
+            weakDriver = handle.promise().weakDriver;
+            driven = true;
+        }
+    }
+
+    void operator()() const {
+        if (!driven) {
+            handle.resume();
+        } else if (auto driver = weakDriver.lock()) {
+            driver->resume();
+        }
+    }
+
+private:
+    std::coroutine_handle<> handle;
+    std::weak_ptr<CoroutineDriver> weakDriver;
+    bool driven = false;
+};
+
+template <typename T, typename Result>
+class ObservableAwaitable {
+public:
+    explicit ObservableAwaitable(Observable<T> observable) : observable(std::move(observable)) {}
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) {
+        state->resumer = Resumer(handle);
+        subscription = observable.subscribe(observer());
+
+        // If the result arrived during `subscribe`, continue without suspending
+        return !state->ready.exchange(true, std::memory_order_acq_rel);
+    }
+
+    Result await_resume() {
+        subscription.unsubscribe();
+
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+
+        return std::move(*state->result);
+    }
+
+protected:
+    struct State {
+        std::atomic<bool> ready = false;
+        std::atomic<bool> finished = false;
+        Resumer resumer;
+        std::optional<Result> result;
+        std::exception_ptr error;
+        std::vector<T> values;
+
+        void finish() {
+            if (finished.exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+
+            if (ready.exchange(true, std::memory_order_acq_rel)) {
+                resumer();
+            }
+        }
+    };
+
+    const std::shared_ptr<State> state = std::make_shared<State>();
+
+    virtual Observer<T> observer() const = 0;
+
+private:
+    Observable<T> observable;
+    Subscription subscription;
+};
+
+template <typename T>
+class FirstAwaitable : public ObservableAwaitable<T, T> {
+public:
+    using ObservableAwaitable<T, T>::ObservableAwaitable;
+
+protected:
+    Observer<T> observer() const override {
+        using State = typename ObservableAwaitable<T, T>::State;
+
+        return Observer<T>(
+            [weakState = std::weak_ptr<State>(this->state)](const T& t) {
+                auto state = weakState.lock();
+                if (state && !state->finished.load(std::memory_order_acquire) && !state->result) {
+                    state->result = t;
+                    state->finish();
+                }
+            },
+            [weakState = std::weak_ptr<State>(this->state)](const std::exception_ptr& err) {
+                if (auto state = weakState.lock(); state && !state->finished.load(std::memory_order_acquire)) {
+                    state->error = err;
+                    state->finish();
+                }
+            },
+            [weakState = std::weak_ptr<State>(this->state)]() {
+                if (auto state = weakState.lock(); state && !state->finished.load(std::memory_order_acquire)) {
+                    state->error = std::make_exception_ptr(std::out_of_range("Observable completed without emitting a value"));
+                    state->finish();
+                }
+            }
+        );
+    }
+};
+
+template <typename T>
+class VectorAwaitable : public ObservableAwaitable<T, std::vector<T>> {
+public:
+    using ObservableAwaitable<T, std::vector<T>>::ObservableAwaitable;
+
+protected:
+    Observer<T> observer() const override {
+        using State = typename ObservableAwaitable<T, std::vector<T>>::State;
+
+        return Observer<T>(
+            [weakState = std::weak_ptr<State>(this->state)](const T& t) {
+                if (auto state = weakState.lock()) {
+                    state->values.push_back(t);
+                }
+            },
+            [weakState = std::weak_ptr<State>(this->state)](const std::exception_ptr& err) {
+                if (auto state = weakState.lock()) {
+                    state->error = err;
+                    state->finish();
+                }
+            },
+            [weakState = std::weak_ptr<State>(this->state)]() {
+                if (auto state = weakState.lock()) {
+                    state->result = std::move(state->values);
+                    state->finish();
+                }
+            }
+        );
+    }
+};
+
+} // namespace impl
+
+template <typename T>
+class AsyncGenerator {
+public:
+    class promise_type : public impl::FrameAllocation {
+    public:
+        AsyncGenerator get_return_object() {
+            return AsyncGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        auto yield_value(const T& value) {
+            subscriber->next(value);
+
+            // Stop at this point once nobody is interested in further values
+            struct YieldAwaiter {
+                bool inactive;
+
+                bool await_ready() const noexcept { return !inactive; }
+                void await_suspend(std::coroutine_handle<>) const noexcept {}
+                void await_resume() const noexcept {}
+            };
+
+            return YieldAwaiter{subscriber->isInactive()};
+        }
+
+        void return_void() {
+            subscriber->complete();
+        }
+
+        void unhandled_exception() {
+            subscriber->error(std::current_exception());
+        }
+
+    private:
+        std::shared_ptr<const Subscriber<T>> subscriber;
+        std::weak_ptr<impl::CoroutineDriver> weakDriver;
+
+        friend class AsyncGenerator;
+        friend class impl::Resumer;
+    };
+
+    AsyncGenerator(AsyncGenerator&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    AsyncGenerator& operator=(AsyncGenerator&&) = delete;
+
+    ~AsyncGenerator() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit AsyncGenerator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    TeardownLogic start(const Subscriber<T>& subscriber) && {
+        auto driver = std::make_shared<impl::CoroutineDriver>(handle);
+        handle.promise().subscriber = subscriber.shared_from_this();
+        handle.promise().weakDriver = driver;
+        handle = nullptr;
+
+        driver->resume();
+
+        return [driver]() {
+            driver->cancel();
+        };
+    }
+
+    friend class Observable<T>;
+};
+
+template <typename T>
+template <typename Func>
+requires std::same_as<std::invoke_result_t<Func&>, AsyncGenerator<T>>
+Observable<T> Observable<T>::create(Func&& coroutine) {
+    return Observable<T>([coroutine = std::forward<Func>(coroutine)](const Subscriber<T>& subscriber) mutable -> TeardownLogic {
+        return std::invoke(coroutine).start(subscriber);
+    });
+}
+
+template <typename T>
+impl::FirstAwaitable<T> Observable<T>::first() const {
+    return impl::FirstAwaitable<T>(*this);
+}
+
+template <typename T>
+impl::VectorAwaitable<T> Observable<T>::toVector() const {
+    return impl::VectorAwaitable<T>(*this);
+}
+
+} // namespace RxLite
@@ -0,0 +1,632 @@
+#pragma once
+
+#include <condition_variable>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+#include <version>
+
+#if defined(__cpp_lib_senders)
+#include <execution>
+#define RXLITE_HAS_EXECUTION 1
+#elif __has_include(<stdexec/execution.hpp>)
+#include <stdexec/execution.hpp>
+#define RXLITE_HAS_EXECUTION 1
+#endif
+
+#include "observable.hpp"
+#include "scheduler/timer_queue.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief A Scheduler that runs its actions on a sender/receiver (P2300) scheduler.
+ *
+ * `ExecutionScheduler` lets RxLite share an execution context, such as a thread pool, with
+ * code built on senders. Actions that are due are handed to the wrapped scheduler in batches:
+ * one `schedule()` operation drains everything that is due, so actions do not allocate an
+ * operation each. Because P2300 schedulers have no notion of time, delayed actions wait on a
+ * helper thread that is started on first use and only submits a batch once it is due.
+ *
+ * The adapter works with `std::execution`, with stdexec, and otherwise with any scheduler
+ * that follows the member protocol of P2300 (`schedule()`, `connect()`, `start()` and
+ * `set_value()`/`set_error()`/`set_stopped()`).
+ */
+class ExecutionScheduler;
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+#if defined(__cpp_lib_senders)
+namespace execution = std::execution;
+#elif defined(RXLITE_HAS_EXECUTION)
+namespace execution = ::stdexec;
+#endif
+
+template <typename Receiver, typename... Args>
+void setValue(Receiver& receiver, Args&&... args) noexcept {
+#if defined(RXLITE_HAS_EXECUTION)
+    execution::set_value(std::move(receiver), std::forward<Args>(args)...);
+#else
+    std::move(receiver).set_value(std::forward<Args>(args)...);
+#endif
+}
+
+template <typename Receiver, typename Error>
+void setError(Receiver& receiver, Error&& error) noexcept {
+#if defined(RXLITE_HAS_EXECUTION)
+    execution::set_error(std::move(receiver), std::forward<Error>(error));
+#else
+    std::move(receiver).set_error(std::forward<Error>(error));
+#endif
+}
+
+template <typename Sender, typename Receiver>
+auto connect(Sender&& sender, Receiver&& receiver) {
+#if defined(RXLITE_HAS_EXECUTION)
+    return execution::connect(std::forward<Sender>(sender), std::forward<Receiver>(receiver));
+#else
+    return std::forward<Sender>(sender).connect(std::forward<Receiver>(receiver));
+#endif
+}
+
+template <typename Operation>
+void start(Operation& operation) noexcept {
+#if defined(RXLITE_HAS_EXECUTION)
+    execution::start(operation);
+#else
+    operation.start();
+#endif
+}
+
+template <typename SenderScheduler>
+auto schedule(SenderScheduler& scheduler) {
+#if defined(RXLITE_HAS_EXECUTION)
+    return execution::schedule(scheduler);
+#else
+    return scheduler.schedule();
+#endif
+}
+
+template <typename Error>
+std::exception_ptr toExceptionPtr(Error&& error) {
+    if constexpr (std::same_as<std::decay_t<Error>, std::exception_ptr>) {
+        return std::forward<Error>(error);
+    } else if constexpr (std::same_as<std::decay_t<Error>, std::error_code>) {
+        return std::make_exception_ptr(std::system_error(error));
+    } else {
+        return std::make_exception_ptr(std::forward<Error>(error));
+    }
+}
+
+// The operation state of `Scheduler::schedule()`. It embeds the timer slot it arms, so
+// starting it and completing it allocate nothing.
+template <typename Receiver>
+class ScheduleOperation {
+public:
+    ScheduleOperation(std::shared_ptr<SchedulerBase> context, Receiver receiver)
+        : context(std::move(context)), receiver(std::move(receiver)),
+          slot([this]() { setValue(this->receiver); }) {}
+
+    ScheduleOperation(const ScheduleOperation&) = delete;
+    ScheduleOperation& operator=(const ScheduleOperation&) = delete;
+
+    void start() & noexcept {
+        // Does not own the slot: the operation state outlives it by contract
+        std::shared_ptr<TimerSlot> unowned(std::shared_ptr<TimerSlot>(), &slot);
+
+        try {
+            context->arm(unowned, context->now());
+        } catch (...) {
+            setError(receiver, std::current_exception());
+        }
+    }
+
+private:
+    const std::shared_ptr<SchedulerBase> context;
+    Receiver receiver;
+    TimerSlot slot;
+};
+
+class ScheduleSender {
+public:
+#if defined(RXLITE_HAS_EXECUTION)
+    using sender_concept = execution::sender_t;
+    using completion_signatures = execution::completion_signatures<
+        execution::set_value_t(), execution::set_error_t(std::exception_ptr)>;
+
+    struct Env {
+        std::shared_ptr<SchedulerBase> context;
+
+        Scheduler query(execution::get_completion_scheduler_t<execution::set_value_t>) const noexcept;
+    };
+
+    Env get_env() const noexcept {
+        return Env{context};
+    }
+#endif
+
+    explicit ScheduleSender(std::shared_ptr<SchedulerBase> context) : context(std::move(context)) {}
+
+    template <typename Receiver>
+    ScheduleOperation<Receiver> connect(Receiver receiver) const {
+        return ScheduleOperation<Receiver>(context, std::move(receiver));
+    }
+
+private:
+    std::shared_ptr<SchedulerBase> context;
+};
+
+enum class ValueMode {
+    First,
+    Last
+};
+
+// The operation state of `firstValueFrom()` and `lastValueFrom()`. Values are delivered
+// straight from the observer to the receiver; the link only lets late callbacks of the
+// source find out that the operation has completed and may already be gone.
+template <typename T, ValueMode Mode, typename Receiver>
+class ObservableOperation {
+public:
+    ObservableOperation(Observable<T> observable, Receiver receiver)
+        : observable(std::move(observable)), receiver(std::move(receiver)) {}
+
+    ObservableOperation(const ObservableOperation&) = delete;
+    ObservableOperation& operator=(const ObservableOperation&) = delete;
+
+    ~ObservableOperation() {
+        detach();
+    }
+
+    void start() & noexcept {
+        // The operation may complete, and be destroyed, before `subscribe` returns. The link is
+        // not embedded in the operation: unsubscribing does not wait for callbacks that are
+        // already under way, so the source may still reach the link after the operation is gone
+        std::shared_ptr<Link> link = std::make_shared<Link>();
+        link->target = this;
+        this->link = link;
+
+        try {
+            Subscription subscribed = observable.subscribe(observer());
+
+            std::unique_lock lock(link->mutex);
+            if (link->target) {
+                subscription = std::move(subscribed);
+            } else {
+                lock.unlock();
+                subscribed.unsubscribe();
+            }
+        } catch (...) {
+            std::unique_lock lock(link->mutex);
+            if (std::exchange(link->target, nullptr)) {
+                lock.unlock();
+                setError(receiver, std::current_exception());
+            }
+        }
+    }
+
+private:
+    struct Link {
+        std::mutex mutex;
+        ObservableOperation* target = nullptr;
+    };
+
+    Observable<T> observable;
+    Receiver receiver;
+    std::shared_ptr<Link> link;
+    Subscription subscription;
+    std::optional<T> value;
+
+    void detach() {
+        if (link) {
+            std::unique_lock lock(link->mutex);
+            link->target = nullptr;
+        }
+    }
+
+    void finish() {
+        Subscription finished = std::move(subscription);
+        finished.unsubscribe();
+    }
+
+    Observer<T> observer() {
+        return Observer<T>(
+            [link = link](const T& t) {
+                std::unique_lock lock(link->mutex);
+                ObservableOperation* operation = link->target;
+                if (!operation) {
+                    return;
+                }
+
+                if constexpr (Mode == ValueMode::First) {
+                    link->target = nullptr;
+                    lock.unlock();
+                    operation->finish();
+                    setValue(operation->receiver, t);
+                } else {
+                    operation->value = t;
+                }
+            },
+            [link = link](const std::exception_ptr& err) {
+                std::unique_lock lock(link->mutex);
+                if (ObservableOperation* operation = std::exchange(link->target, nullptr)) {
+                    lock.unlock();
+                    setError(operation->receiver, err);
+                }
+            },
+            [link = link]() {
+                std::unique_lock lock(link->mutex);
+                if (ObservableOperation* operation = std::exchange(link->target, nullptr)) {
+                    lock.unlock();
+                    if (operation->value) {
+                        setValue(operation->receiver, std::move(*operation->value));
+                    } else {
+                        setError(operation->receiver, std::make_exception_ptr(
+                            std::out_of_range("Observable completed without emitting a value")));
+                    }
+                }
+            }
+        );
+    }
+};
+
+template <typename T, ValueMode Mode>
+class ObservableSender {
+public:
+#if defined(RXLITE_HAS_EXECUTION)
+    using sender_concept = execution::sender_t;
+    using completion_signatures = execution::completion_signatures<
+        execution::set_value_t(T), execution::set_error_t(std::exception_ptr)>;
+#endif
+
+    explicit ObservableSender(Observable<T> observable) : observable(std::move(observable)) {}
+
+    template <typename Receiver>
+    ObservableOperation<T, Mode, Receiver> connect(Receiver receiver) const {
+        return ObservableOperation<T, Mode, Receiver>(observable, std::move(receiver));
+    }
+
+private:
+    Observable<T> observable;
+};
+
+// Connects a sender for one subscription of `fromSender()` and keeps the operation state
+// alive until the sender completes, even if the subscriber unsubscribes before.
+template <typename T, typename Sender>
+class SenderSubscription {
+public:
+    class Receiver {
+    public:
+#if defined(RXLITE_HAS_EXECUTION)
+        using receiver_concept = execution::receiver_t;
+
+        struct Env {
+            std::stop_token token;
+
+            std::stop_token query(execution::get_stop_token_t) const noexcept {
+                return token;
+            }
+        };
+
+        Env get_env() const noexcept {
+            return Env{owner->stopSource.get_token()};
+        }
+#endif
+
+        explicit Receiver(SenderSubscription* owner) : owner(owner) {}
+
+        template <typename... Args>
+        void set_value(Args&&... args) && noexcept {
+            std::shared_ptr<SenderSubscription> self = std::move(owner->self);
+
+            try {
+                if constexpr (sizeof...(Args) > 0) {
+                    owner->subscriber->next(T(std::forward<Args>(args)...));
+                }
+
+                owner->subscriber->complete();
+            } catch (...) {
+                owner->subscriber->error(std::current_exception());
+            }
+        }
+
+        template <typename Error>
+        void set_error(Error&& error) && noexcept {
+            std::shared_ptr<SenderSubscription> self = std::move(owner->self);
+            owner->subscriber->error(toExceptionPtr(std::forward<Error>(error)));
+        }
+
+        void set_stopped() && noexcept {
+            std::shared_ptr<SenderSubscription> self = std::move(owner->self);
+            owner->subscriber->complete();
+        }
+
+    private:
+        SenderSubscription* owner;
+    };
+
+    SenderSubscription(Sender sender, const Subscriber<T>& subscriber)
+        : subscriber(subscriber.shared_from_this()), operation(impl::connect(std::move(sender), Receiver(this))) {}
+
+    static TeardownLogic start(Sender sender, const Subscriber<T>& subscriber) {
+        auto shared = std::make_shared<SenderSubscription>(std::move(sender), subscriber);
+        shared->self = shared;
+        impl::start(shared->operation);
+
+        return [weak = std::weak_ptr<SenderSubscription>(shared)]() {
+            if (auto shared = weak.lock()) {
+                shared->stopSource.request_stop();
+            }
+        };
+    }
+
+private:
+    using Operation = decltype(impl::connect(std::declval<Sender>(), std::declval<Receiver>()));
+
+    const std::shared_ptr<const Subscriber<T>> subscriber;
+    std::stop_source stopSource;
+    std::shared_ptr<SenderSubscription> self;
+    Operation operation;
+};
+
+template <typename SenderScheduler>
+class ExecutionContext : public TimerQueueContext<HeapTimerQueue>,
+                         public std::enable_shared_from_this<ExecutionContext<SenderScheduler>> {
+public:
+    explicit ExecutionContext(SenderScheduler scheduler) : scheduler(std::move(scheduler)) {}
+
+    ~ExecutionContext() override {
+        {
+            std::unique_lock lock(mutex);
+            stopped = true;
+        }
+
+        wakeup.notify_one();
+
+        // The timer thread drops the last handle itself if an inline drain released the others
+        if (timerThread.get_id() == std::this_thread::get_id()) {
+            timerThread.detach();
+        } else if (timerThread.joinable()) {
+            timerThread.join();
+        }
+    }
+
+    Clock::time_point now() const override {
+        return Clock::now();
+    }
+
+    void arm(const std::shared_ptr<TimerSlot>& slot, Clock::time_point due) override {
+        TimerQueueContext<HeapTimerQueue>::arm(slot, due);
+        submitRequested();
+    }
+
+protected:
+    void onArmed(Clock::time_point due) override {
+        if (due <= Clock::now()) {
+            requestDrain();
+            return;
+        }
+
+        if (!timerThread.joinable()) {
+            timerThread = std::thread([weak = this->weak_from_this()]() { waitForTimers(weak); });
+        }
+
+        if (due < sleepingUntil) {
+            sleepingUntil = due;
+            wakeup.notify_one();
+        }
+    }
+
+private:
+    class DrainReceiver {
+    public:
+#if defined(RXLITE_HAS_EXECUTION)
+        using receiver_concept = execution::receiver_t;
+#endif
+
+        explicit DrainReceiver(ExecutionContext* context) : context(context) {}
+
+        void set_value() && noexcept {
+            context->drain();
+        }
+
+        void set_error(std::exception_ptr) && noexcept {
+            context->drain();
+        }
+
+        void set_stopped() && noexcept {
+            context->drain();
+        }
+
+    private:
+        ExecutionContext* context;
+    };
+
+    // Wraps the operation state so that it can be constructed in place from `connect()`
+    struct Drain {
+        decltype(impl::connect(impl::schedule(std::declval<SenderScheduler&>()), std::declval<DrainReceiver>())) operation;
+
+        Drain(SenderScheduler& scheduler, ExecutionContext* context)
+            : operation(impl::connect(impl::schedule(scheduler), DrainReceiver(context))) {}
+    };
+
+    SenderScheduler scheduler;
+    std::optional<Drain> pending;
+    std::shared_ptr<ExecutionContext> keepAlive;
+    bool draining = false;
+    bool startRequested = false;
+
+    std::thread timerThread;
+    std::condition_variable wakeup;
+    Clock::time_point sleepingUntil = Clock::time_point::max();
+    bool stopped = false;
+
+    // Called with the mutex held
+    void requestDrain() {
+        if (!draining) {
+            draining = true;
+            startRequested = true;
+        }
+    }
+
+    // Called without the mutex held, since the scheduler may complete inline
+    void submitRequested() {
+        {
+            std::unique_lock lock(mutex);
+            if (!std::exchange(startRequested, false)) {
+                return;
+            }
+
+            keepAlive = this->shared_from_this();
+            pending.emplace(scheduler, this);
+        }
+
+        impl::start(pending->operation);
+    }
+
+    void drain() {
+        std::shared_ptr<ExecutionContext> self;
+        std::vector<ExpiredTimer> batch;
+        std::unique_lock lock(mutex);
+
+        while (true) {
+            queue.expire(Clock::now(), batch);
+            if (batch.empty()) {
+                break;
+            }
+
+            lock.unlock();
+            run(batch);
+            batch.clear();
+            lock.lock();
+        }
+
+        // The operation state must not be touched past this point; it may be replaced
+        // by the next drain as soon as the mutex is released
+        draining = false;
+        self = std::move(keepAlive);
+        wakeup.notify_one();
+    }
+
+    // Holds a strong reference only while submitting, so that dropping the last handle
+    // elsewhere stops and joins this thread while it waits
+    static void waitForTimers(const std::weak_ptr<ExecutionContext>& weak) {
+        while (std::shared_ptr<ExecutionContext> self = weak.lock()) {
+            std::unique_lock lock(self->mutex);
+            std::optional<Clock::time_point> due = self->queue.nextDue();
+
+            if (!self->draining && due && *due <= Clock::now()) {
+                self->requestDrain();
+                lock.unlock();
+                self->submitRequested();
+                continue;
+            }
+
+            lock.unlock();
+            ExecutionContext* context = self.get();
+            self.reset();
+            if (weak.expired()) {
+                return;
+            }
+
+            // A destructor that runs from here on waits for this thread before freeing the context
+            lock = std::unique_lock(context->mutex);
+            if (context->stopped) {
+                return;
+            }
+
+            due = context->queue.nextDue();
+            if (context->draining || !due) {
+                // A running drain picks up everything that is due and wakes us when done
+                context->sleepingUntil = Clock::time_point::max();
+                context->wakeup.wait(lock);
+            } else if (*due > Clock::now()) {
+                context->sleepingUntil = *due;
+                context->wakeup.wait_until(lock, *due);
+            }
+
+            context->sleepingUntil = Clock::time_point::min();
+        }
+    }
+};
+
+} // namespace impl
+
+class ExecutionScheduler : public Scheduler {
+public:
+    /**
+     * @brief Wraps a sender/receiver scheduler.
+     *
+     * @param scheduler The scheduler whose execution context runs the actions.
+     */
+    template <typename SenderScheduler>
+    explicit ExecutionScheduler(SenderScheduler scheduler)
+        : Scheduler(std::make_shared<impl::ExecutionContext<SenderScheduler>>(std::move(scheduler))) {}
+};
+
+/**
+ * @brief Creates a sender that completes with the first value of an observable.
+ *
+ * Starting the sender subscribes to the observable; the first value is passed to `set_value`
+ * and the subscription is cancelled. If the observable errors, or completes without a value
+ * (as `std::out_of_range`), the error is passed to `set_error`. Values go straight from the
+ * observable to the receiver, without being queued or allocated.
+ *
+ * @param observable The observable to subscribe to.
+ * @return A sender of the first value.
+ */
+template <typename T>
+impl::ObservableSender<T, impl::ValueMode::First> firstValueFrom(Observable<T> observable) {
+    return impl::ObservableSender<T, impl::ValueMode::First>(std::move(observable));
+}
+
+/**
+ * @brief Creates a sender that completes with the last value of an observable.
+ *
+ * Starting the sender subscribes to the observable. Once it completes, its last value is
+ * passed to `set_value`. If the observable errors, or completes without a value (as
+ * `std::out_of_range`), the error is passed to `set_error`.
+ *
+ * @param observable The observable to subscribe to.
+ * @return A sender of the last value.
+ */
+template <typename T>
+impl::ObservableSender<T, impl::ValueMode::Last> lastValueFrom(Observable<T> observable) {
+    return impl::ObservableSender<T, impl::ValueMode::Last>(std::move(observable));
+}
+
+/**
+ * @brief Creates an observable from a sender.
+ *
+ * Each subscription connects and starts its own copy of the sender. A value sent by the
+ * sender is emitted, converted to `T`, followed by completion; senders that complete without
+ * a value, or are stopped, only complete. Errors are forwarded as exceptions.
+ *
+ * Unsubscribing requests the sender to stop through its receiver's stop token; the operation
+ * is kept alive until the sender has completed.
+ *
+ * @tparam T The type of values emitted by the observable.
+ * @param sender The sender to start for each subscription.
+ * @return Observable<T> An observable of the sender's value.
+ */
+template <typename T, typename Sender>
+Observable<T> fromSender(Sender sender) {
+    return Observable<T>([sender = std::move(sender)](const Subscriber<T>& subscriber) -> TeardownLogic {
+        return impl::SenderSubscription<T, Sender>::start(sender, subscriber);
+    });
+}
+
+#if defined(RXLITE_HAS_EXECUTION)
+inline Scheduler impl::ScheduleSender::Env::query(execution::get_completion_scheduler_t<execution::set_value_t>) const noexcept {
+    return Scheduler(context);
+}
+#endif
+
+} // namespace RxLite
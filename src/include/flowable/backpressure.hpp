@@ -0,0 +1,275 @@
+#pragma once
+
+#include "flowable/flowable.hpp"
+#include "flowable/ring_buffer.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief What `onBackpressureBuffer` does with a value that does not fit into its buffer.
+ */
+enum class OverflowPolicy {
+    Error,      ///< Signal `MissingBackpressure` downstream right away.
+    DropOldest, ///< Evict the oldest buffered value to make room.
+    DropNewest  ///< Discard the value that did not fit.
+};
+
+/**
+ * @brief Whether the source of a backpressure buffer emits from one thread at a time.
+ *
+ * Observables emit sequentially, so `Single` is right for most sources. A `Subject` that is
+ * fed from several threads at once needs `Multiple`.
+ */
+enum class Producers {
+    Single,
+    Multiple
+};
+
+/**
+ * @brief The metrics callback of the backpressure operators.
+ *
+ * Invoked on the producer's thread with the total number of values dropped so far, each time
+ * a value is dropped.
+ */
+using DropCallback = std::function<void(std::uint64_t)>;
+
+/**
+ * @brief Defines a function that turns an observable into a flowable.
+ *
+ * @tparam T The type of values emitted by both.
+ */
+template <typename T>
+using BackpressureOperator = std::function<Flowable<T>(Observable<T>&)>;
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// Buffers the values of an observable until the downstream subscriber requests them.
+// Values are handed over from the producer to whichever thread drains the buffer next;
+// draining is serialized with a work-in-progress counter.
+template <typename T, typename RingBuffer>
+class BackpressureBuffer {
+public:
+    BackpressureBuffer(std::shared_ptr<const FlowSubscriber<T>> downstream, std::size_t capacity, OverflowPolicy policy, DropCallback onDrop)
+        : downstream(std::move(downstream)), buffer(capacity), policy(policy), onDrop(std::move(onDrop)) {}
+
+    void next(const T& t) {
+        if (done.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        if (!buffer.push(t)) {
+            switch (policy) {
+            case OverflowPolicy::Error:
+                finish(std::make_exception_ptr(MissingBackpressure()), true);
+                return;
+            case OverflowPolicy::DropOldest:
+                do {
+                    if (buffer.pop()) {
+                        drop();
+                    }
+                } while (!buffer.push(t));
+                break;
+            case OverflowPolicy::DropNewest:
+                drop();
+                break;
+            }
+        }
+
+        drain();
+    }
+
+    void finish(std::exception_ptr err, bool overflow = false) {
+        if (finishing.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+
+        error = std::move(err);
+        overflowed = overflow;
+        done.store(true, std::memory_order_release);
+        drain();
+    }
+
+    void drain() {
+        if (wip.fetch_add(1, std::memory_order_acq_rel) != 0) {
+            return;
+        }
+
+        int missed = 1;
+
+        do {
+            while (!downstream->isInactive()) {
+                bool finished = done.load(std::memory_order_acquire);
+                if (finished && overflowed) {
+                    downstream->error(error);
+                    break;
+                }
+
+                if (downstream->requested() == 0) {
+                    if (finished && buffer.empty()) {
+                        terminate();
+                    }
+                    break;
+                }
+
+                std::optional<T> value = buffer.pop();
+                if (!value) {
+                    if (finished) {
+                        terminate();
+                    }
+                    break;
+                }
+
+                downstream->next(*value);
+            }
+
+            missed = wip.fetch_sub(missed, std::memory_order_acq_rel) - missed;
+        } while (missed != 0);
+    }
+
+private:
+    const std::shared_ptr<const FlowSubscriber<T>> downstream;
+    RingBuffer buffer;
+    const OverflowPolicy policy;
+    const DropCallback onDrop;
+
+    std::atomic<int> wip = 0;
+    std::atomic<bool> finishing = false;
+    std::atomic<bool> done = false;
+    std::exception_ptr error;
+    bool overflowed = false;
+    std::atomic<std::uint64_t> dropped = 0;
+
+    void drop() {
+        std::uint64_t count = dropped.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (onDrop) {
+            onDrop(count);
+        }
+    }
+
+    void terminate() {
+        if (error) {
+            downstream->error(error);
+        } else {
+            downstream->complete();
+        }
+    }
+};
+
+template <typename T, typename RingBuffer>
+TeardownLogic subscribeBuffered(const Observable<T>& source, const FlowSubscriber<T>& subscriber,
+                                std::size_t capacity, OverflowPolicy policy, DropCallback onDrop) {
+    auto buffer = std::make_shared<BackpressureBuffer<T, RingBuffer>>(subscriber.shared_from_this(), capacity, policy, std::move(onDrop));
+    subscriber.onRequest([buffer](std::uint64_t) { buffer->drain(); });
+
+    Subscription upstream = source.subscribe(Observer<T>(
+        [buffer](const T& t) { buffer->next(t); },
+        [buffer](const std::exception_ptr& err) { buffer->finish(err); },
+        [buffer]() { buffer->finish(nullptr); }
+    ));
+
+    return [upstream]() mutable {
+        upstream.unsubscribe();
+    };
+}
+
+} // namespace impl
+
+/**
+ * @brief Converts an observable into a flowable by buffering values until they are requested.
+ *
+ * Values are queued in a ring buffer that is allocated once per subscription, so buffering a
+ * value never allocates. Whenever the subscriber has demand, queued values are handed to it,
+ * on the producer's thread or on the thread that requested them. Completion and upstream errors
+ * are delivered after the buffered values. When the buffer is full, `policy` decides: `Error`
+ * signals `MissingBackpressure` immediately, the drop policies discard a value and report it
+ * to `onDrop`.
+ *
+ * With `Producers::Single` the buffer is a single-producer ring; with `Producers::Multiple`, or
+ * with `OverflowPolicy::DropOldest`, which evicts from the producer's side, it is a
+ * multi-producer ring.
+ *
+ * @tparam T The type of values emitted by the observable.
+ * @param capacity The number of values the buffer holds.
+ * @param policy What to do when the buffer is full.
+ * @param onDrop The metrics callback, invoked with the total drop count whenever a value is dropped.
+ * @param producers Whether the observable emits from several threads at once.
+ * @return BackpressureOperator<T> A function that converts an observable into a flowable.
+ * @throws std::invalid_argument On subscription, if the capacity is zero.
+ */
+template <typename T>
+BackpressureOperator<T> onBackpressureBuffer(std::size_t capacity, OverflowPolicy policy = OverflowPolicy::Error,
+                                             DropCallback onDrop = nullptr, Producers producers = Producers::Single) {
+    return [capacity, policy, onDrop, producers](const Observable<T>& sourceObservable) {
+        return Flowable<T>([capacity, policy, onDrop, producers, sourceObservable](const FlowSubscriber<T>& subscriber) -> TeardownLogic {
+            if (producers == Producers::Single && policy != OverflowPolicy::DropOldest) {
+                return impl::subscribeBuffered<T, impl::SpscRingBuffer<T>>(sourceObservable, subscriber, capacity, policy, onDrop);
+            }
+
+            return impl::subscribeBuffered<T, impl::MpmcRingBuffer<T>>(sourceObservable, subscriber, capacity, policy, onDrop);
+        });
+    };
+}
+
+/**
+ * @brief Converts an observable into a flowable that drops values nobody requested.
+ *
+ * Values are passed on while the subscriber has demand and discarded otherwise; nothing is
+ * buffered.
+ *
+ * @tparam T The type of values emitted by the observable.
+ * @param onDrop The metrics callback, invoked with the total drop count whenever a value is dropped.
+ * @return BackpressureOperator<T> A function that converts an observable into a flowable.
+ */
+template <typename T>
+BackpressureOperator<T> onBackpressureDrop(DropCallback onDrop = nullptr) {
+    return [onDrop](const Observable<T>& sourceObservable) {
+        return Flowable<T>([onDrop, sourceObservable](const FlowSubscriber<T>& subscriber) -> TeardownLogic {
+            auto dropped = std::make_shared<std::atomic<std::uint64_t>>(0);
+
+            Subscription upstream = sourceObservable.subscribe(Observer<T>(
+                [onDrop, dropped, subscriber = subscriber.shared_from_this()](const T& t) {
+                    if (subscriber->requested() > 0) {
+                        subscriber->next(t);
+                        return;
+                    }
+
+                    std::uint64_t count = dropped->fetch_add(1, std::memory_order_relaxed) + 1;
+                    if (onDrop) {
+                        onDrop(count);
+                    }
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    subscriber->error(err);
+                },
+                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
+            ));
+
+            return [upstream]() mutable {
+                upstream.unsubscribe();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Converts an observable into a flowable that keeps only the latest unrequested value.
+ *
+ * While the subscriber has no demand, each new value replaces the one held back, which is
+ * reported as dropped. The held value is delivered as soon as the subscriber requests more.
+ *
+ * @tparam T The type of values emitted by the observable.
+ * @param onDrop The metrics callback, invoked with the total drop count whenever a value is dropped.
+ * @return BackpressureOperator<T> A function that converts an observable into a flowable.
+ */
+template <typename T>
+BackpressureOperator<T> onBackpressureLatest(DropCallback onDrop = nullptr) {
+    return onBackpressureBuffer<T>(1, OverflowPolicy::DropOldest, std::move(onDrop));
+}
+
+} // namespace RxLite
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "observable.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief A sequence of values over time whose consumers control the rate of emission.
+ *
+ * A `Flowable<T>` is the backpressured counterpart of `Observable<T>`. Its subscribers signal
+ * demand with `request(n)`, and a flowable never emits more values than were requested. A slow
+ * consumer therefore slows down its producer instead of making values pile up in unbounded
+ * buffers, and the memory of a pipeline stays bounded by the demand its consumers request.
+ *
+ * By default, `subscribe()` requests values in batches on behalf of the observer: it requests
+ * a prefetch amount up front and requests more each time three quarters of it were consumed.
+ * Operators in `RxLite::flowable` propagate demand upstream in the same batched fashion.
+ *
+ * @tparam T The type of values emitted by this flowable.
+ */
+template <typename T>
+class Flowable;
+
+template <typename T>
+class FlowSubscriber;
+
+/**
+ * @brief The error signalled when a producer emits more values than were requested.
+ */
+class MissingBackpressure : public std::runtime_error {
+public:
+    MissingBackpressure() : std::runtime_error("Value emitted without demand") {}
+};
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// Adds to a demand counter, saturating at the unbounded demand
+inline void addDemand(std::atomic<std::uint64_t>& demand, std::uint64_t n) {
+    std::uint64_t current = demand.load(std::memory_order_relaxed);
+    std::uint64_t next;
+
+    do {
+        next = n > std::numeric_limits<std::uint64_t>::max() - current ? std::numeric_limits<std::uint64_t>::max() : current + n;
+    } while (!demand.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+}
+
+// The demand shared between a FlowSubscriber and the FlowSubscriptions handed out for it.
+// Requests are passed to the producer one at a time, never concurrently or re-entrantly.
+class FlowState : public std::enable_shared_from_this<FlowState> {
+public:
+    static constexpr std::uint64_t Unbounded = std::numeric_limits<std::uint64_t>::max();
+
+    std::atomic<std::uint64_t> requested = 0;
+
+    // Automatic replenishment, only touched by the (serialized) emitting thread
+    std::uint64_t limit = 0;
+    std::uint64_t consumed = 0;
+
+    void setOnRequest(std::function<void(std::uint64_t)> func) {
+        onRequest = std::move(func);
+    }
+
+    void request(std::uint64_t n) {
+        if (n == 0 || cancelled.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        addDemand(requested, n);
+        addDemand(pending, n);
+        serialize();
+    }
+
+    // Releases the producer; further requests are ignored
+    void cancel() {
+        if (!cancelled.exchange(true, std::memory_order_acq_rel)) {
+            serialize();
+        }
+    }
+
+private:
+    std::atomic<std::uint64_t> pending = 0;
+    std::atomic<bool> cancelled = false;
+    std::atomic<int> wip = 0;
+    std::function<void(std::uint64_t)> onRequest;
+
+    void serialize() {
+        if (wip.fetch_add(1, std::memory_order_acq_rel) != 0) {
+            // Picked up by the thread that is already passing requests on
+            return;
+        }
+
+        std::shared_ptr<FlowState> self = shared_from_this();
+        int missed = 1;
+
+        do {
+            if (cancelled.load(std::memory_order_acquire)) {
+                onRequest = nullptr;
+            } else if (std::uint64_t n = pending.exchange(0, std::memory_order_acq_rel); n > 0 && onRequest) {
+                onRequest(n);
+            }
+
+            missed = wip.fetch_sub(missed, std::memory_order_acq_rel) - missed;
+        } while (missed != 0);
+    }
+};
+
+} // namespace impl
+
+/**
+ * @brief A Subscription to a Flowable, through which the consumer signals demand.
+ */
+class FlowSubscription : public Subscription {
+public:
+    /**
+     * @brief The demand that lets a flowable emit without limit.
+     */
+    static constexpr std::uint64_t Unbounded = impl::FlowState::Unbounded;
+
+    /**
+     * @brief Constructs an empty FlowSubscription.
+     */
+    FlowSubscription() = default;
+
+    /**
+     * @brief Requests `n` more values from the flowable.
+     *
+     * The producer may emit the values right away, on the calling thread, or later. Demand
+     * adds up and saturates at `Unbounded`. Requesting zero values has no effect.
+     *
+     * @param n The number of additional values the consumer is ready to receive.
+     */
+    void request(std::uint64_t n) const {
+        if (state) {
+            state->request(n);
+        }
+    }
+
+protected:
+    template <typename T>
+    FlowSubscription(Subscriber<T> subscriber, TeardownLogic teardownLogic, std::shared_ptr<impl::FlowState> state)
+        : Subscription(std::move(subscriber), [teardownLogic = std::move(teardownLogic), state]() {
+              state->cancel();
+              teardownLogic();
+          }),
+          state(std::move(state)) {}
+
+private:
+    std::shared_ptr<impl::FlowState> state;
+};
+
+/**
+ * @brief A Subscriber of a Flowable.
+ *
+ * Producers receive a `FlowSubscriber` on subscription. They register a callback with
+ * `onRequest()` that is invoked whenever the consumer requests more values, and they may
+ * only emit while `requested()` is greater than zero. Emitting without demand errors the
+ * subscriber with `MissingBackpressure`.
+ *
+ * @tparam T The type of data received by the subscriber.
+ */
+template <typename T>
+class FlowSubscriber : public Subscriber<T> {
+public:
+    /**
+     * @brief Receives the next value, consuming one unit of demand.
+     *
+     * @param t The value emitted by the Flowable.
+     */
+    void next(const T& t) const {
+        if (this->isInactive()) {
+            return;
+        }
+
+        std::uint64_t requested = state->requested.load(std::memory_order_acquire);
+        if (requested == 0) {
+            error(std::make_exception_ptr(MissingBackpressure()));
+            return;
+        }
+
+        if (requested != FlowSubscription::Unbounded) {
+            state->requested.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        Subscriber<T>::next(t);
+
+        if (state->limit != 0 && ++state->consumed == state->limit) {
+            state->consumed = 0;
+            state->request(state->limit);
+        }
+    }
+
+    /**
+     * @brief Receives an error signal and releases the producer.
+     *
+     * @param err The exception pointer representing the error.
+     */
+    void error(const std::exception_ptr& err) const {
+        Subscriber<T>::error(err);
+        state->cancel();
+    }
+
+    /**
+     * @brief Receives the completion signal and releases the producer.
+     */
+    void complete() const {
+        Subscriber<T>::complete();
+        state->cancel();
+    }
+
+    /**
+     * @brief Returns the number of values the producer may still emit.
+     *
+     * @return std::uint64_t The outstanding demand, or `FlowSubscription::Unbounded`.
+     */
+    std::uint64_t requested() const {
+        return state->requested.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Registers the callback invoked whenever the consumer requests more values.
+     *
+     * The callback receives the number of values just requested. Invocations never overlap
+     * and never nest: a request made while the callback runs, e.g. by an observer that the
+     * callback emits to, is passed on once the callback returns. Must be called from the
+     * producer's subscribe function; the callback is released once the subscriber is done.
+     *
+     * @param func The callback, taking the number of requested values.
+     */
+    void onRequest(std::function<void(std::uint64_t)> func) const {
+        state->setOnRequest(std::move(func));
+    }
+
+    std::shared_ptr<const FlowSubscriber<T>> shared_from_this() const {
+        return std::static_pointer_cast<const FlowSubscriber<T>>(Subscriber<T>::shared_from_this());
+    }
+
+protected:
+    FlowSubscriber(Observer<T> observer, std::uint64_t prefetch)
+        : Subscriber<T>(std::move(observer)), state(std::make_shared<impl::FlowState>()) {
+        if (prefetch != 0 && prefetch != FlowSubscription::Unbounded) {
+            state->limit = std::max<std::uint64_t>(prefetch - prefetch / 4, 1);
+        }
+    }
+
+private:
+    const std::shared_ptr<impl::FlowState> state;
+
+    friend class Flowable<T>;
+};
+
+template <typename T>
+class Flowable {
+public:
+    /**
+     * @brief The number of values requested at once by default.
+     */
+    static constexpr std::uint64_t DefaultPrefetch = 128;
+
+    /**
+     * @brief Creates a flowable with a given subscribe function.
+     *
+     * The function is called for each subscriber. It registers an `onRequest()` callback
+     * and emits values as demand allows, either from that callback or whenever it has data.
+     *
+     * @param onSubscribe A function taking a `FlowSubscriber<T>` and returning its teardown logic.
+     */
+    template <typename Func>
+    requires std::invocable<Func, const FlowSubscriber<T>&> &&
+             std::is_same_v<std::invoke_result_t<Func, const FlowSubscriber<T>&>, TeardownLogic>
+    explicit Flowable(Func&& onSubscribe)
+        : sharedOnSubscribe(std::make_shared<OnSubscribe>(std::forward<Func>(onSubscribe))) {}
+
+    /**
+     * @brief Creates a flowable that emits the values of a vector as they are requested.
+     *
+     * @param values The values to emit.
+     * @return Flowable<T> A flowable that emits all values and then completes.
+     */
+    static Flowable<T> from(std::vector<T> values) {
+        return Flowable<T>([values = std::make_shared<const std::vector<T>>(std::move(values))](const FlowSubscriber<T>& subscriber) -> TeardownLogic {
+            if (values->empty()) {
+                subscriber.complete();
+                return []() {};
+            }
+
+            subscriber.onRequest([values, index = std::size_t(0), subscriber = subscriber.shared_from_this()](std::uint64_t) mutable {
+                while (subscriber->requested() > 0 && !subscriber->isInactive()) {
+                    subscriber->next((*values)[index++]);
+
+                    if (index == values->size()) {
+                        subscriber->complete();
+                    }
+                }
+            });
+
+            return []() {};
+        });
+    }
+
+    /**
+     * @brief Subscribes an observer, requesting values on its behalf.
+     *
+     * `prefetch` values are requested right away. Each time three quarters of them were
+     * delivered, the same number is requested again, so the observer never holds more than
+     * `prefetch` outstanding values. With a prefetch of zero nothing is requested
+     * automatically and the consumer calls `FlowSubscription::request()` itself.
+     *
+     * @param observer The observer that will receive emitted values.
+     * @param prefetch The number of values requested at once, `0` or `FlowSubscription::Unbounded`.
+     * @return FlowSubscription The subscription, through which more values can be requested.
+     */
+    FlowSubscription subscribe(Observer<T> observer, std::uint64_t prefetch = DefaultPrefetch) const {
+        auto subscriber = std::make_shared<SubscriberFactory>(std::move(observer), prefetch);
+        std::shared_ptr<impl::FlowState> state = subscriber->state;
+
+        TeardownLogic teardownLogic = (*sharedOnSubscribe)(*subscriber);
+        FlowSubscription subscription = SubscriptionFactory(*subscriber, std::move(teardownLogic), state);
+        subscription.request(prefetch);
+        return subscription;
+    }
+
+    /**
+     * @brief Converts the flowable into an Observable that requests values without limit.
+     *
+     * @return Observable<T> An observable emitting the same values.
+     */
+    Observable<T> toObservable() const {
+        return impl::ObservableFactory<T>([source = *this](const Subscriber<T>& subscriber) -> TeardownLogic {
+            FlowSubscription subscription = source.subscribe(Observer<T>(
+                [subscriber = subscriber.shared_from_this()](const T& t) { subscriber->next(t); },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { subscriber->error(err); },
+                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
+            ), FlowSubscription::Unbounded);
+
+            return [subscription]() mutable {
+                subscription.unsubscribe();
+            };
+        });
+    }
+
+    /**
+     * @brief Applies a sequence of operators to the flowable.
+     *
+     * @param first The first function to apply.
+     * @param rest Additional functions to apply.
+     * @return The transformed flowable or final result after applying all functions.
+     */
+    template <typename First, typename... Rest>
+    requires std::is_invocable_v<First, Flowable<T>&>
+    auto pipe(First&& first, Rest&&... rest) {
+        if constexpr (sizeof...(rest) == 0) {
+            return std::forward<First>(first)(*this);
+        } else {
+            return std::forward<First>(first)(*this).pipe(std::forward<Rest>(rest)...);
+        }
+    }
+
+private:
+    using OnSubscribe = std::function<TeardownLogic(const FlowSubscriber<T>&)>;
+
+    class SubscriberFactory : public FlowSubscriber<T> {
+    public:
+        SubscriberFactory(Observer<T> observer, std::uint64_t prefetch)
+            : FlowSubscriber<T>(std::move(observer), prefetch) {}
+    };
+
+    class SubscriptionFactory : public FlowSubscription {
+    public:
+        SubscriptionFactory(Subscriber<T> subscriber, TeardownLogic teardownLogic, std::shared_ptr<impl::FlowState> state)
+            : FlowSubscription(std::move(subscriber), std::move(teardownLogic), std::move(state)) {}
+    };
+
+    std::shared_ptr<const OnSubscribe> sharedOnSubscribe;
+};
+
+} // namespace RxLite
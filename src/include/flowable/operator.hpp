@@ -0,0 +1,294 @@
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "flowable/flowable.hpp"
+#include "scheduler/scheduler.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief Defines a transformation function that maps one flowable type to another.
+ *
+ * @tparam T The input flowable type.
+ * @tparam U The output flowable type.
+ */
+template <typename T, typename U>
+using FlowableOperator = std::function<Flowable<U>(Flowable<T>&)>;
+
+/**
+ * @brief Operators for flowables.
+ *
+ * These operators mirror the operators for observables, but pass the demand of their
+ * subscribers upstream, so that a pipeline never buffers more than its consumers requested.
+ */
+namespace flowable {
+
+/**
+ * @brief Keeps only the values that satisfy a predicate.
+ *
+ * Demand is passed upstream unchanged. Every value that is filtered out leaves a unit of
+ * demand unused; these are collected and requested from upstream again in batches, at the
+ * latest once all demand passed upstream has been served.
+ *
+ * @tparam T The type of values emitted by the source flowable.
+ * @param predicate A callable returning true for the values to keep.
+ * @return FlowableOperator<T, T> A function that applies the filter to a flowable.
+ */
+template <typename T, typename Func>
+requires std::predicate<Func&, const T&>
+FlowableOperator<T, T> filter(Func&& predicate) {
+    return [predicate = std::forward<Func>(predicate)](const Flowable<T>& sourceFlowable) {
+        return Flowable<T>([predicate, sourceFlowable](const FlowSubscriber<T>& subscriber) -> TeardownLogic {
+            static constexpr std::uint64_t Batch = Flowable<T>::DefaultPrefetch / 4;
+
+            struct State {
+                FlowSubscription upstream;
+                std::atomic<std::uint64_t> inFlight = 0;
+                std::uint64_t dropped = 0;
+            };
+
+            auto state = std::make_shared<State>();
+            std::weak_ptr<State> weakState = state;
+
+            state->upstream = sourceFlowable.subscribe(Observer<T>(
+                [predicate, weakState, subscriber = subscriber.shared_from_this()](const T& t) {
+                    auto state = weakState.lock();
+                    if (!state) {
+                        return;
+                    }
+
+                    if (std::invoke(predicate, t)) {
+                        subscriber->next(t);
+                    } else {
+                        state->dropped++;
+                    }
+
+                    std::uint64_t remaining = state->inFlight.load(std::memory_order_acquire);
+                    if (remaining == FlowSubscription::Unbounded) {
+                        return;
+                    }
+
+                    remaining = state->inFlight.fetch_sub(1, std::memory_order_acq_rel) - 1;
+                    if (state->dropped > 0 && (remaining == 0 || state->dropped >= Batch)) {
+                        std::uint64_t n = std::exchange(state->dropped, 0);
+                        impl::addDemand(state->inFlight, n);
+                        state->upstream.request(n);
+                    }
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    subscriber->error(err);
+                },
+                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
+            ), 0);
+
+            subscriber.onRequest([state](std::uint64_t n) {
+                impl::addDemand(state->inFlight, n);
+                state->upstream.request(n);
+            });
+
+            return [state]() {
+                state->upstream.unsubscribe();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Transforms the values of a flowable using a mapping function.
+ *
+ * Each value is mapped to exactly one value, so demand is passed upstream unchanged.
+ *
+ * @tparam T The input value type.
+ * @param mapFunc A callable that transforms values of type `T` to an output type `U` (deduced automatically).
+ * @return FlowableOperator<T, U> A function that applies the transformation to a flowable.
+ */
+template <typename T, typename Func, typename U = std::invoke_result_t<Func, const T&>>
+FlowableOperator<T, U> map(Func&& mapFunc) {
+    return [mapFunc = std::forward<Func>(mapFunc)](const Flowable<T>& sourceFlowable) {
+        return Flowable<U>([mapFunc, sourceFlowable](const FlowSubscriber<U>& subscriber) -> TeardownLogic {
+            FlowSubscription upstream = sourceFlowable.subscribe(Observer<T>(
+                [mapFunc, subscriber = subscriber.shared_from_this()](const T& t) {
+                    subscriber->next(std::invoke(mapFunc, t));
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    subscriber->error(err);
+                },
+                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
+            ), 0);
+
+            subscriber.onRequest([upstream](std::uint64_t n) {
+                upstream.request(n);
+            });
+
+            return [upstream]() mutable {
+                upstream.unsubscribe();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Re-emits the values of a flowable on the given scheduler, through a bounded queue.
+ *
+ * `observeOn` requests `prefetch` values from upstream and queues them until the downstream
+ * subscriber requests them, which happens on `scheduler`. Each time three quarters of the
+ * queue were handed downstream, that many values are requested from upstream again. The
+ * queue therefore never holds more than `prefetch` values, however far the consumer lags
+ * behind. Errors and completion are delivered after the values that preceded them.
+ *
+ * @tparam T The type of values emitted by the source flowable.
+ * @param scheduler The scheduler on which values are delivered.
+ * @param prefetch The capacity of the queue, and the number of values requested at once.
+ * @return FlowableOperator<T, T> A function that moves the delivery of a flowable onto the scheduler.
+ */
+template <typename T>
+FlowableOperator<T, T> observeOn(Scheduler scheduler, std::uint64_t prefetch = Flowable<T>::DefaultPrefetch) {
+    return [scheduler, prefetch](const Flowable<T>& sourceFlowable) {
+        return Flowable<T>([scheduler, prefetch, sourceFlowable](const FlowSubscriber<T>& subscriber) -> TeardownLogic {
+            struct State {
+                const std::shared_ptr<const FlowSubscriber<T>> downstream;
+                const std::uint64_t limit;
+                FlowSubscription upstream;
+                Timer drainTimer;
+                std::atomic<int> wip = 0;
+                std::uint64_t consumed = 0;
+
+                // Ring buffer of `capacity` values, guarded by the mutex
+                std::mutex mutex;
+                std::vector<std::optional<T>> queue;
+                std::size_t head = 0;
+                std::size_t count = 0;
+                bool done = false;
+                std::exception_ptr error;
+
+                State(std::shared_ptr<const FlowSubscriber<T>> downstream, std::uint64_t prefetch)
+                    : downstream(std::move(downstream)), limit(std::max<std::uint64_t>(prefetch - prefetch / 4, 1)),
+                      queue(prefetch) {}
+
+                void schedule() {
+                    if (wip.fetch_add(1, std::memory_order_acq_rel) == 0) {
+                        drainTimer.rescheduleAfter(Scheduler::Duration::zero());
+                    }
+                }
+
+                void push(const T& t) {
+                    {
+                        std::unique_lock lock(mutex);
+                        if (count == queue.size()) {
+                            error = std::make_exception_ptr(MissingBackpressure());
+                            done = true;
+                        } else {
+                            queue[(head + count) % queue.size()] = t;
+                            count++;
+                        }
+                    }
+
+                    schedule();
+                }
+
+                void finish(std::exception_ptr err) {
+                    {
+                        std::unique_lock lock(mutex);
+                        error = std::move(err);
+                        done = true;
+                    }
+
+                    schedule();
+                }
+
+                void drain() {
+                    int missed = 1;
+
+                    do {
+                        while (!downstream->isInactive()) {
+                            std::optional<T> value;
+                            bool finished = false;
+
+                            {
+                                std::unique_lock lock(mutex);
+                                if (count == 0) {
+                                    finished = done;
+                                } else if (downstream->requested() > 0) {
+                                    value = std::move(queue[head]);
+                                    queue[head].reset();
+                                    head = (head + 1) % queue.size();
+                                    count--;
+                                }
+                            }
+
+                            if (finished) {
+                                if (error) {
+                                    downstream->error(error);
+                                } else {
+                                    downstream->complete();
+                                }
+                                break;
+                            }
+
+                            if (!value) {
+                                break;
+                            }
+
+                            downstream->next(*value);
+
+                            if (++consumed == limit) {
+                                consumed = 0;
+                                upstream.request(limit);
+                            }
+                        }
+
+                        missed = wip.fetch_sub(missed, std::memory_order_acq_rel) - missed;
+                    } while (missed != 0);
+                }
+            };
+
+            auto state = std::make_shared<State>(subscriber.shared_from_this(), std::max<std::uint64_t>(prefetch, 1));
+            std::weak_ptr<State> weakState = state;
+
+            state->drainTimer = scheduler.createTimer([weakState]() {
+                if (auto state = weakState.lock()) {
+                    state->drain();
+                }
+            });
+
+            state->upstream = sourceFlowable.subscribe(Observer<T>(
+                [weakState](const T& t) {
+                    if (auto state = weakState.lock()) {
+                        state->push(t);
+                    }
+                },
+                [weakState](const std::exception_ptr& err) {
+                    if (auto state = weakState.lock()) {
+                        state->finish(err);
+                    }
+                },
+                [weakState]() {
+                    if (auto state = weakState.lock()) {
+                        state->finish(nullptr);
+                    }
+                }
+            ), 0);
+
+            subscriber.onRequest([weakState](std::uint64_t) {
+                if (auto state = weakState.lock()) {
+                    state->schedule();
+                }
+            });
+
+            state->upstream.request(state->queue.size());
+
+            return [state]() {
+                state->upstream.unsubscribe();
+                state->drainTimer.cancel();
+            };
+        });
+    };
+}
+
+} // namespace flowable
+
+} // namespace RxLite
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "container/cache_line.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// A bounded, lock-free queue for one producer and one consumer thread.
+// All slots are allocated up front; push and pop never allocate.
+template <typename T>
+class SpscRingBuffer {
+public:
+    explicit SpscRingBuffer(std::size_t capacity) : slots(capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Ring buffer capacity must be positive");
+        }
+    }
+
+    std::size_t capacity() const {
+        return slots.size();
+    }
+
+    // Producer only; returns false if the buffer is full
+    bool push(const T& value) {
+        std::size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail - cachedHead == slots.size()) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (tail - cachedHead == slots.size()) {
+                return false;
+            }
+        }
+
+        slots[tail % slots.size()] = value;
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only; returns an empty optional if the buffer is empty
+    std::optional<T> pop() {
+        std::size_t head = this->head.load(std::memory_order_relaxed);
+        if (head == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (head == cachedTail) {
+                return std::nullopt;
+            }
+        }
+
+        std::optional<T>& slot = slots[head % slots.size()];
+        std::optional<T> value = std::move(slot);
+        slot.reset();
+        this->head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<std::optional<T>> slots;
+
+    alignas(CacheLineSize) std::atomic<std::size_t> head = 0;
+    std::size_t cachedTail = 0;
+
+    alignas(CacheLineSize) std::atomic<std::size_t> tail = 0;
+    std::size_t cachedHead = 0;
+};
+
+// A bounded, lock-free queue for any number of producer and consumer threads (D. Vyukov's
+// bounded MPMC queue). Each slot carries a sequence number that tells producers and
+// consumers whose turn it is, so that claiming a slot takes a single CAS. The sequence is
+// 2 * position while the slot awaits the producer of `position` and 2 * position + 1 while it
+// awaits the consumer, which keeps the two states apart even for a capacity of one.
+template <typename T>
+class MpmcRingBuffer {
+public:
+    explicit MpmcRingBuffer(std::size_t capacity) : size(capacity), slots(std::make_unique<Slot[]>(capacity)) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Ring buffer capacity must be positive");
+        }
+
+        for (std::size_t i = 0; i < capacity; i++) {
+            slots[i].sequence.store(2 * i, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t capacity() const {
+        return size;
+    }
+
+    // Returns false if the buffer is full
+    bool push(const T& value) {
+        std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Slot& slot = slots[position % size];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::intptr_t>(sequence - 2 * position);
+
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(2 * position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns an empty optional if the buffer is empty
+    std::optional<T> pop() {
+        std::size_t position = dequeuePosition.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Slot& slot = slots[position % size];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::intptr_t>(sequence - (2 * position + 1));
+
+            if (difference == 0) {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    std::optional<T> value = std::move(slot.value);
+                    slot.value.reset();
+                    slot.sequence.store(2 * (position + size), std::memory_order_release);
+                    return value;
+                }
+            } else if (difference < 0) {
+                return std::nullopt;
+            } else {
+                position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Exact once all producers are done
+    bool empty() const {
+        return dequeuePosition.load(std::memory_order_acquire) == enqueuePosition.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        std::optional<T> value;
+    };
+
+    const std::size_t size;
+    const std::unique_ptr<Slot[]> slots;
+
+    alignas(CacheLineSize) std::atomic<std::size_t> enqueuePosition = 0;
+    alignas(CacheLineSize) std::atomic<std::size_t> dequeuePosition = 0;
+};
+
+} // namespace impl
+
+} // namespace RxLite
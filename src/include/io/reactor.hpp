@@ -0,0 +1,447 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "../observable.hpp"
+#include "../scheduler/affinity.hpp"
+#include "../scheduler/timer_queue.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief Multiplexes file descriptors and timers on a single thread.
+ *
+ * A `Reactor` owns one thread that waits on an epoll instance. File descriptors such as
+ * sockets and pipes are exposed as observables: `fromFd()` emits the data read from a
+ * descriptor, and `whenReady()` emits its readiness events. Thousands of descriptors can
+ * share one reactor. A reactor is also a Scheduler, so timers and other work can run on
+ * the same thread as the I/O callbacks.
+ *
+ * Reads go into fixed-size buffers taken from a pool owned by the reactor. The spans
+ * emitted by `fromFd()` point into such a buffer and are only valid until `next`
+ * returns; subscribers that need the data later must copy it.
+ *
+ * The reactor thread can be pinned to CPUs and a NUMA node with an `Affinity`. Its read
+ * buffers are then allocated by the pinned thread itself, i.e. from node-local memory.
+ *
+ * The reactor thread stops once the last copy of the reactor is destroyed. Only available
+ * on Linux.
+ */
+class Reactor;
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+class BufferPool {
+public:
+    explicit BufferPool(std::size_t bufferSize) : bufferSize(bufferSize) {}
+
+    void reserve(std::size_t count) {
+        std::unique_lock lock(mutex);
+        while (buffers.size() < count) {
+            buffers.push_back(std::make_unique<std::byte[]>(bufferSize));
+        }
+    }
+
+    std::unique_ptr<std::byte[]> acquire() {
+        std::unique_lock lock(mutex);
+        if (buffers.empty()) {
+            return std::make_unique<std::byte[]>(bufferSize);
+        }
+
+        std::unique_ptr<std::byte[]> buffer = std::move(buffers.back());
+        buffers.pop_back();
+        return buffer;
+    }
+
+    void release(std::unique_ptr<std::byte[]> buffer) {
+        std::unique_lock lock(mutex);
+        buffers.push_back(std::move(buffer));
+    }
+
+    std::size_t size() const {
+        return bufferSize;
+    }
+
+private:
+    const std::size_t bufferSize;
+    std::vector<std::unique_ptr<std::byte[]>> buffers;
+    std::mutex mutex;
+};
+
+class ReactorContext : public TimerQueueContext<HeapTimerQueue> {
+public:
+    // Invoked on the reactor thread with the registration id and the epoll event mask
+    using Handler = std::function<void(std::uint64_t, std::uint32_t)>;
+
+    explicit ReactorContext(std::size_t bufferSize) : pool(bufferSize) {
+        epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        wakeupFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epollFd < 0 || wakeupFd < 0) {
+            int err = errno;
+            closeAll();
+            throw std::system_error(err, std::generic_category(), "Reactor");
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = WakeupId;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeupFd, &event);
+    }
+
+    // Starts the reactor thread; it only refers to the context through a weak pointer, see `loop()`
+    static std::shared_ptr<ReactorContext> start(std::shared_ptr<ReactorContext> context, const Affinity& affinity, std::size_t pooledBuffers) {
+        // The buffers are allocated by the (possibly pinned) reactor thread, so they are first
+        // touched on its NUMA node
+        context->worker = std::thread([weakContext = std::weak_ptr<ReactorContext>(context), affinity, pooledBuffers]() {
+            applyAffinity(affinity);
+            if (auto context = weakContext.lock()) {
+                context->pool.reserve(pooledBuffers);
+            }
+
+            loop(weakContext);
+        });
+
+        return context;
+    }
+
+    ~ReactorContext() override {
+        {
+            std::unique_lock lock(mutex);
+            stopped = true;
+        }
+
+        wake();
+
+        if (worker.get_id() == std::this_thread::get_id()) {
+            // The last handle was dropped by a callback running on the reactor, which returns right after
+            worker.detach();
+        } else if (worker.joinable()) {
+            worker.join();
+        }
+
+        // Closing the epoll instance also drops the registrations of all watched descriptors
+        closeAll();
+    }
+
+    Clock::time_point now() const override {
+        return Clock::now();
+    }
+
+    std::uint64_t watch(int fd, std::uint32_t events, Handler handler) {
+        std::uint64_t id;
+
+        {
+            std::unique_lock lock(mutex);
+            id = nextId++;
+            handlers.emplace(id, std::make_shared<Registration>(std::move(handler)));
+        }
+
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = id;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            int err = errno;
+            std::unique_lock lock(mutex);
+            handlers.erase(id);
+            throw std::system_error(err, std::generic_category(), "epoll_ctl");
+        }
+
+        return id;
+    }
+
+    void unwatch(int fd, std::uint64_t id) {
+        std::unique_lock lock(mutex);
+        auto it = handlers.find(id);
+        if (it == handlers.end()) {
+            return;
+        }
+
+        // The loop may have collected an event for it already, see `loop()`
+        it->second->watched.store(false, std::memory_order_release);
+        handlers.erase(it);
+        ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    BufferPool& buffers() {
+        return pool;
+    }
+
+protected:
+    void onArmed(Clock::time_point due) override {
+        if (due < sleepingUntil) {
+            sleepingUntil = due;
+            wake();
+        }
+    }
+
+private:
+    static constexpr std::uint64_t WakeupId = 0;
+    static constexpr int MaxEvents = 256;
+
+    struct Registration {
+        const Handler handler;
+        std::atomic<bool> watched = true;
+
+        explicit Registration(Handler handler) : handler(std::move(handler)) {}
+    };
+
+    int epollFd = -1;
+    int wakeupFd = -1;
+    std::thread worker;
+    std::unordered_map<std::uint64_t, std::shared_ptr<Registration>> handlers;
+    std::uint64_t nextId = WakeupId + 1;
+    BufferPool pool;
+    Clock::time_point sleepingUntil = Clock::time_point::max();
+    bool stopped = false;
+
+    void wake() const {
+        std::uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = ::write(wakeupFd, &one, sizeof(one));
+    }
+
+    void closeAll() {
+        if (epollFd >= 0) {
+            ::close(epollFd);
+        }
+
+        if (wakeupFd >= 0) {
+            ::close(wakeupFd);
+        }
+    }
+
+    // Timers and handlers run while the loop holds a handle, so a callback that drops the
+    // last other handle cannot free the context under the loop; the context is then destroyed
+    // on this thread once they are done, and the loop finds the weak pointer expired. While
+    // it waits for events, the loop holds no handle, so the context can only be destroyed by
+    // another thread, which wakes and joins the reactor thread before the members go away.
+    static void loop(const std::weak_ptr<ReactorContext>& weakContext) {
+        std::vector<ExpiredTimer> batch;
+        std::vector<std::tuple<std::shared_ptr<Registration>, std::uint64_t, std::uint32_t>> ready;
+        epoll_event events[MaxEvents];
+
+        while (true) {
+            ReactorContext* context;
+            int timeout = -1;
+
+            {
+                std::shared_ptr<ReactorContext> self = weakContext.lock();
+                if (!self) {
+                    return;
+                }
+
+                for (const auto& [registration, id, mask] : ready) {
+                    // Skip descriptors unwatched since their events were collected; they may be
+                    // closed, or even reused, by now
+                    if (registration->watched.load(std::memory_order_acquire)) {
+                        registration->handler(id, mask);
+                    }
+                }
+
+                ready.clear();
+
+                {
+                    std::unique_lock lock(self->mutex);
+                    self->queue.expire(Clock::now(), batch);
+
+                    if (batch.empty()) {
+                        std::optional<Clock::time_point> due = self->queue.nextDue();
+                        self->sleepingUntil = due.value_or(Clock::time_point::max());
+
+                        if (due) {
+                            auto wait = std::chrono::ceil<std::chrono::milliseconds>(*due - Clock::now());
+                            timeout = static_cast<int>(std::clamp<std::chrono::milliseconds::rep>(wait.count(), 0, INT32_MAX));
+                        }
+                    } else {
+                        timeout = 0;
+                    }
+                }
+
+                self->run(batch);
+                batch.clear();
+                context = self.get();
+            }
+
+            if (weakContext.expired()) {
+                return;
+            }
+
+            int count = ::epoll_wait(context->epollFd, events, MaxEvents, timeout);
+
+            std::unique_lock lock(context->mutex);
+            if (context->stopped) {
+                return;
+            }
+
+            context->sleepingUntil = Clock::time_point::min();
+
+            for (int i = 0; i < count; i++) {
+                if (events[i].data.u64 == WakeupId) {
+                    std::uint64_t value;
+                    [[maybe_unused]] ssize_t bytes = ::read(context->wakeupFd, &value, sizeof(value));
+                    continue;
+                }
+
+                auto it = context->handlers.find(events[i].data.u64);
+                if (it != context->handlers.end()) {
+                    ready.emplace_back(it->second, it->first, std::uint32_t(events[i].events));
+                }
+            }
+        }
+    }
+};
+
+} // namespace impl
+
+class Reactor : public Scheduler {
+public:
+    /**
+     * @brief Starts a new reactor thread.
+     *
+     * @param bufferSize The size of each read buffer, i.e. the maximum size of an emitted chunk.
+     * @param pooledBuffers The number of read buffers allocated up front.
+     */
+    explicit Reactor(std::size_t bufferSize = 64 * 1024, std::size_t pooledBuffers = 1)
+        : Reactor(Affinity(), bufferSize, pooledBuffers) {}
+
+    /**
+     * @brief Starts a new reactor thread that is pinned according to `affinity`.
+     *
+     * @param affinity The CPUs and NUMA node of the reactor thread, its state and its buffers.
+     * @param bufferSize The size of each read buffer, i.e. the maximum size of an emitted chunk.
+     * @param pooledBuffers The number of read buffers allocated up front.
+     */
+    explicit Reactor(const Affinity& affinity, std::size_t bufferSize = 64 * 1024, std::size_t pooledBuffers = 1)
+        : Scheduler(impl::ReactorContext::start(impl::makeContext<impl::ReactorContext>(affinity, bufferSize), affinity, pooledBuffers)) {}
+
+    /**
+     * @brief Creates an observable that emits the data read from a file descriptor.
+     *
+     * On subscription the descriptor is switched to non-blocking mode and registered with
+     * the reactor. Each chunk read from it is emitted as a span into a pooled buffer, valid
+     * until `next` returns. The observable completes when the descriptor reaches end of
+     * file and errors with a `std::system_error` if reading fails. Unsubscribing removes the
+     * descriptor from the reactor; it is never closed by the reactor.
+     *
+     * A descriptor can only be watched by one subscription of a reactor at a time.
+     *
+     * @param fd The file descriptor to read from.
+     * @return Observable<std::span<const std::byte>> An observable of the chunks read.
+     */
+    Observable<std::span<const std::byte>> fromFd(int fd) const {
+        using Chunk = std::span<const std::byte>;
+
+        return Observable<Chunk>([context = sharedReactor(), fd](const Subscriber<Chunk>& subscriber) -> TeardownLogic {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+            std::weak_ptr<impl::ReactorContext> weakContext = context;
+
+            auto onEvents = [weakContext, fd, subscriber = subscriber.shared_from_this()](std::uint64_t id, std::uint32_t) {
+                auto context = weakContext.lock();
+                if (!context) {
+                    return;
+                }
+
+                impl::BufferPool& pool = context->buffers();
+                std::unique_ptr<std::byte[]> buffer = pool.acquire();
+
+                while (true) {
+                    ssize_t bytes = ::read(fd, buffer.get(), pool.size());
+
+                    if (bytes > 0) {
+                        subscriber->next(Chunk(buffer.get(), static_cast<std::size_t>(bytes)));
+                    } else if (bytes == 0) {
+                        context->unwatch(fd, id);
+                        subscriber->complete();
+                        break;
+                    } else if (errno == EINTR) {
+                        continue;
+                    } else {
+                        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                            context->unwatch(fd, id);
+                            subscriber->error(std::make_exception_ptr(
+                                std::system_error(errno, std::generic_category(), "read")));
+                        }
+                        break;
+                    }
+                }
+
+                pool.release(std::move(buffer));
+            };
+
+            std::uint64_t id;
+
+            try {
+                id = context->watch(fd, EPOLLIN | EPOLLRDHUP | EPOLLET, std::move(onEvents));
+            } catch (...) {
+                subscriber.error(std::current_exception());
+                return []() {};
+            }
+
+            return [weakContext, fd, id]() {
+                if (auto context = weakContext.lock()) {
+                    context->unwatch(fd, id);
+                }
+            };
+        });
+    }
+
+    /**
+     * @brief Creates an observable that emits the readiness events of a file descriptor.
+     *
+     * The descriptor is registered edge-triggered: each emitted value is the epoll event
+     * mask (e.g. `EPOLLIN`, `EPOLLOUT`) of a readiness change, and the subscriber is expected
+     * to read or write until the operation would block. The observable never completes on
+     * its own. Unsubscribing removes the descriptor from the reactor.
+     *
+     * @param fd The file descriptor to watch.
+     * @param events The epoll events of interest, e.g. `EPOLLIN | EPOLLOUT`.
+     * @return Observable<std::uint32_t> An observable of readiness event masks.
+     */
+    Observable<std::uint32_t> whenReady(int fd, std::uint32_t events = EPOLLIN) const {
+        return Observable<std::uint32_t>([context = sharedReactor(), fd, events](const Subscriber<std::uint32_t>& subscriber) -> TeardownLogic {
+            std::uint64_t id;
+
+            try {
+                id = context->watch(fd, events | EPOLLET, [subscriber = subscriber.shared_from_this()](std::uint64_t, std::uint32_t mask) {
+                    subscriber->next(mask);
+                });
+            } catch (...) {
+                subscriber.error(std::current_exception());
+                return []() {};
+            }
+
+            return [weakContext = std::weak_ptr<impl::ReactorContext>(context), fd, id]() {
+                if (auto context = weakContext.lock()) {
+                    context->unwatch(fd, id);
+                }
+            };
+        });
+    }
+
+private:
+    std::shared_ptr<impl::ReactorContext> sharedReactor() const {
+        return std::static_pointer_cast<impl::ReactorContext>(sharedContext);
+    }
+};
+
+} // namespace RxLite
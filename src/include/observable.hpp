@@ -5,6 +5,19 @@
 
 namespace RxLite {
 
+template <typename T>
+class AsyncGenerator;
+
+namespace impl {
+
+template <typename T>
+class FirstAwaitable;
+
+template <typename T>
+class VectorAwaitable;
+
+} // namespace impl
+
 /**
  * @brief Represents a sequence of values over time.
  * 
@@ -78,6 +91,22 @@ public:
         return Observable<T>(onSubscribe);
     }
 
+    /**
+     * @brief Creates an observable from a coroutine.
+     * 
+     * Every subscription invokes `coroutine` and runs the returned `AsyncGenerator<T>`:
+     * each `co_yield` emits a value, `co_return` completes and an exception errors the 
+     * observable. Unsubscribing stops and destroys the coroutine.
+     * 
+     * Requires `coroutine.hpp`.
+     * 
+     * @param coroutine A callable without parameters that returns an `AsyncGenerator<T>`.
+     * @return Observable<T> An observable that emits the values yielded by the coroutine.
+     */
+    template <typename Func>
+    requires std::same_as<std::invoke_result_t<Func&>, AsyncGenerator<T>>
+    static Observable<T> create(Func&& coroutine);
+
     /**
      * @brief Subscribes an observer to the observable.
      * 
@@ -93,6 +122,31 @@ public:
         return impl::SubscriptionFactory(*sharedSubscriber, teardownLogic);
     }
 
+    /**
+     * @brief Returns an awaitable that resolves to the first value of the observable.
+     * 
+     * `co_await observable.first()` subscribes, suspends the coroutine until the first value
+     * arrives and unsubscribes again. Errors are rethrown; completing without a value throws
+     * `std::out_of_range`.
+     * 
+     * Requires `coroutine.hpp`.
+     * 
+     * @return An awaitable producing the first emitted value.
+     */
+    impl::FirstAwaitable<T> first() const;
+
+    /**
+     * @brief Returns an awaitable that resolves to all values of the observable.
+     * 
+     * `co_await observable.toVector()` subscribes and suspends the coroutine until the 
+     * observable completes. Errors are rethrown.
+     * 
+     * Requires `coroutine.hpp`.
+     * 
+     * @return An awaitable producing all emitted values, in order.
+     */
+    impl::VectorAwaitable<T> toVector() const;
+
     /**
      * @brief Applies a sequence of operators to the observable.
      * 
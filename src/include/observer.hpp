@@ -58,14 +58,22 @@ public:
         sharedInactiveFlag->store(true, std::memory_order_relaxed);
     }
 
+    /**
+     * @brief Checks whether the subscriber stopped receiving notifications.
+     * 
+     * A subscriber becomes inactive when it is unsubscribed, or after it received an 
+     * error or completion signal. Producers can use this to stop early.
+     * 
+     * @return true if further notifications will be ignored.
+     */
+    bool isInactive() const {
+        return sharedInactiveFlag->load(std::memory_order_relaxed);
+    }
+
 protected:
     const std::shared_ptr<std::atomic<bool>> sharedInactiveFlag;
 
     SubscriberBase() : sharedInactiveFlag(std::make_shared<std::atomic<bool>>(false)) {}
-
-    bool isInactive() const {
-        return sharedInactiveFlag->load(std::memory_order_relaxed);
-    }
 };
 
 template <typename T>
@@ -94,7 +102,7 @@ public:
         : ObserverBase(std::move(onError), std::move(onComplete)), onNext(std::forward<OnNext>(onNext)) {}
 
 private:
-    const std::function<void(T)> onNext;
+    const std::function<void(const T&)> onNext;
 
     friend class Subscriber<T>;
 };
@@ -1,10 +1,32 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <optional>
-#include <unordered_set>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
+#include "container/batch_pool.hpp"
+#include "container/blocked_bloom_filter.hpp"
+#include "container/cache_line.hpp"
+#include "container/flat_hash_map.hpp"
+#include "container/ring_queue.hpp"
 #include "observable.hpp"
+#include "scheduler/scheduler.hpp"
+#include "subject/subject.hpp"
+#include "subject/window_subject.hpp"
 
 
 namespace RxLite {
@@ -20,6 +42,583 @@ namespace RxLite {
 template <typename T, typename U>
 using Operator = std::function<Observable<U>(Observable<T>&)>;
 
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// The shared state of the time-based rate limiters: a subscriber, at most one value held
+// back and a single timer that is rescheduled rather than recreated for each value.
+template <typename T>
+struct RateLimiter {
+    const std::shared_ptr<const Subscriber<T>> subscriber;
+    Timer timer;
+
+    // Recursive, as a consumer may feed the source from `next`
+    std::recursive_mutex mutex;
+    std::optional<T> pending;
+
+    explicit RateLimiter(std::shared_ptr<const Subscriber<T>> subscriber) : subscriber(std::move(subscriber)) {}
+
+    // Must be called with the mutex held; returns whether a value was emitted
+    bool emitPending() {
+        if (!pending) {
+            return false;
+        }
+
+        T value = std::move(*pending);
+        pending.reset();
+        subscriber->next(value);
+        return true;
+    }
+
+    // Creates the limiter with a timer that calls `onTimer` with the mutex held
+    template <typename Func>
+    static std::shared_ptr<RateLimiter> create(const Subscriber<T>& subscriber, const Scheduler& scheduler, Func&& onTimer) {
+        auto limiter = std::make_shared<RateLimiter>(subscriber.shared_from_this());
+
+        limiter->timer = scheduler.createTimer([weakLimiter = std::weak_ptr<RateLimiter>(limiter), onTimer = std::forward<Func>(onTimer)]() {
+            if (auto limiter = weakLimiter.lock()) {
+                std::unique_lock lock(limiter->mutex);
+                onTimer(*limiter);
+            }
+        });
+
+        return limiter;
+    }
+
+    // Subscribes to the source; errors drop the held value, completion runs `onComplete` first
+    template <typename OnNext, typename OnComplete>
+    static TeardownLogic subscribe(const std::shared_ptr<RateLimiter>& limiter, const Observable<T>& source, OnNext&& onNext, OnComplete&& onComplete) {
+        Observer<T> intermediateObserver(
+            [limiter, onNext = std::forward<OnNext>(onNext)](const T& t) {
+                std::unique_lock lock(limiter->mutex);
+                onNext(*limiter, t);
+            },
+            [limiter](const std::exception_ptr& err) {
+                std::unique_lock lock(limiter->mutex);
+                limiter->timer.cancel();
+                limiter->pending.reset();
+                limiter->subscriber->error(err);
+            },
+            [limiter, onComplete = std::forward<OnComplete>(onComplete)]() {
+                std::unique_lock lock(limiter->mutex);
+                limiter->timer.cancel();
+                onComplete(*limiter);
+                limiter->subscriber->complete();
+            }
+        );
+
+        return [limiter, subscription = source.subscribe(intermediateObserver)]() mutable {
+            subscription.unsubscribe();
+            limiter->timer.cancel();
+        };
+    }
+};
+
+// The queue between the source and the consumer of `adaptiveBatch`.
+//
+// A drain on the scheduler hands everything that is pending to the consumer as one batch
+// and repeats until nothing is left. A value that finds the consumer idle thus goes out on
+// its own right away, while the values that arrive during a slow `next` pile up and go out
+// together, so batches grow with the backlog rather than with the input rate. The time the
+// consumer takes per value is tracked to keep each batch to what it handles in `maxLatency`.
+template <typename T>
+class AdaptiveBatchState {
+public:
+    AdaptiveBatchState(std::shared_ptr<const Subscriber<std::vector<T>>> subscriber, Scheduler scheduler,
+                       Scheduler::Duration maxLatency, std::size_t maxSize, BatchPool<T> pool)
+        : subscriber(std::move(subscriber)), scheduler(std::move(scheduler)), maxLatency(maxLatency),
+          maxSize(maxSize), pool(std::move(pool)) {}
+
+    static std::shared_ptr<AdaptiveBatchState> create(const Subscriber<std::vector<T>>& subscriber, const Scheduler& scheduler,
+                                                      Scheduler::Duration maxLatency, std::size_t maxSize, BatchPool<T> pool) {
+        auto state = std::make_shared<AdaptiveBatchState>(subscriber.shared_from_this(), scheduler, maxLatency, maxSize, std::move(pool));
+
+        state->timer = scheduler.createTimer([weakState = std::weak_ptr<AdaptiveBatchState>(state)]() {
+            if (auto state = weakState.lock()) {
+                state->drain();
+            }
+        });
+
+        return state;
+    }
+
+    void next(const T& t) {
+        std::unique_lock lock(mutex);
+        if (terminated) {
+            return;
+        }
+
+        pending.push(t);
+        scheduleDrain();
+    }
+
+    // Terminal events are only recorded here; the drain delivers them after the batch in flight
+    void error(const std::exception_ptr& err) {
+        std::unique_lock lock(mutex);
+        if (terminated) {
+            return;
+        }
+
+        terminated = true;
+        terminalError = err;
+        pending.clear();
+        scheduleDrain();
+    }
+
+    void complete() {
+        std::unique_lock lock(mutex);
+        if (terminated) {
+            return;
+        }
+
+        terminated = true;
+        completed = true;
+        scheduleDrain();
+    }
+
+    void cancel() {
+        timer.cancel();
+
+        std::unique_lock lock(mutex);
+        pending.clear();
+    }
+
+private:
+    const std::shared_ptr<const Subscriber<std::vector<T>>> subscriber;
+    const Scheduler scheduler;
+    const Scheduler::Duration maxLatency;
+    const std::size_t maxSize;
+    const BatchPool<T> pool;
+    Timer timer;
+
+    std::mutex mutex;
+    RingQueue<T> pending;
+    Scheduler::Duration costPerValue = Scheduler::Duration::zero();
+    bool scheduled = false;
+    bool terminated = false;
+    bool completed = false;
+    std::exception_ptr terminalError;
+
+    // Must be called with the mutex held
+    void scheduleDrain() {
+        if (!scheduled) {
+            scheduled = true;
+            timer.rescheduleAfter(Scheduler::Duration::zero());
+        }
+    }
+
+    // The number of values the consumer is expected to handle within `maxLatency`
+    std::size_t batchLimit() const {
+        if (costPerValue <= Scheduler::Duration::zero()) {
+            return maxSize;
+        }
+
+        return static_cast<std::size_t>(std::clamp<Scheduler::Duration::rep>(maxLatency / costPerValue, 1, static_cast<Scheduler::Duration::rep>(maxSize)));
+    }
+
+    void drain() {
+        std::unique_lock lock(mutex);
+
+        while (!pending.empty() && !terminalError) {
+            std::size_t count = std::min(pending.size(), batchLimit());
+            std::vector<T> batch = pool.acquire(count);
+            for (std::size_t i = 0; i < count; i++) {
+                batch.push_back(pending.pop());
+            }
+
+            // The source keeps queueing while the consumer handles the batch
+            lock.unlock();
+            Scheduler::TimePoint start = scheduler.now();
+            subscriber->next(batch);
+            Scheduler::Duration elapsed = scheduler.now() - start;
+            pool.recycle(std::move(batch));
+            lock.lock();
+
+            costPerValue += (elapsed / static_cast<Scheduler::Duration::rep>(count) - costPerValue) / 8;
+        }
+
+        scheduled = false;
+
+        // Pending values were cleared by an error, so the queue is empty either way
+        std::exception_ptr err = std::exchange(terminalError, nullptr);
+        bool finished = std::exchange(completed, false);
+        lock.unlock();
+
+        if (err) {
+            subscriber->error(err);
+        } else if (finished) {
+            subscriber->complete();
+        }
+    }
+};
+
+} // namespace impl
+
+/**
+ * @brief Collects values into batches whose size adapts to the backlog of the consumer.
+ *
+ * Fixed batching either delays values at low load or emits small batches at high load. The
+ * `adaptiveBatch` operator instead hands values to the consumer on `scheduler` as soon as it
+ * is free: a value that arrives while the consumer is idle is emitted on its own right away,
+ * and the values that arrive while the consumer handles a batch are emitted together as the
+ * next one. Batches thus grow as queueing builds up and shrink again when it clears, and
+ * the consumer pays its per-batch overhead once per backlog rather than once per value.
+ *
+ * A batch holds at most `maxSize` values, and at most as many as the consumer is estimated
+ * to handle within `maxLatency`, measured on `scheduler`'s clock, so a large backlog is
+ * split rather than handed over as one batch that holds the next values back for long.
+ *
+ * A single timer is reused for all drains. Batch storage comes from `pool` and goes back
+ * there after `next` returns, so a batch is only valid during `next`.
+ *
+ * The resulting observable:
+ * - Emits batches on `scheduler`, in order, never more than one at a time.
+ * - Emits the pending values and completes when the source completes.
+ * - Forwards errors from the source after the batch in flight, discarding pending values.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param maxLatency The time the consumer should take for a batch at most.
+ * @param maxSize The maximum number of values in a batch.
+ * @param scheduler The scheduler on which the consumer runs.
+ * @param pool The pool providing batch storage.
+ * @return Operator<T, std::vector<T>> A function that batches the values of an observable.
+ * @throws std::invalid_argument If `maxLatency` is not positive or `maxSize` is zero.
+ */
+template <typename T>
+Operator<T, std::vector<T>> adaptiveBatch(Scheduler::Duration maxLatency, std::size_t maxSize, Scheduler scheduler, BatchPool<T> pool = BatchPool<T>()) {
+    if (maxLatency <= Scheduler::Duration::zero() || maxSize == 0) {
+        throw std::invalid_argument("adaptiveBatch: maxLatency and maxSize must be positive");
+    }
+
+    return [maxLatency, maxSize, scheduler, pool](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<std::vector<T>>([maxLatency, maxSize, scheduler, pool, sourceObservable](const Subscriber<std::vector<T>>& subscriber) {
+            auto state = impl::AdaptiveBatchState<T>::create(subscriber, scheduler, maxLatency, maxSize, pool);
+
+            Observer<T> intermediateObserver(
+                [state](const T& t) { state->next(t); },
+                [state](const std::exception_ptr& err) { state->error(err); },
+                [state]() { state->complete(); }
+            );
+
+            return [state, subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+                state->cancel();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Emits the latest value once a period of time has passed since the first value.
+ *
+ * The first value starts a timer of `duration`; when it fires, the latest value received
+ * meanwhile is emitted. The next value starts the timer again. Unlike `throttleTime`,
+ * `auditTime` always emits the latest value of a period, and unlike `debounceTime` it
+ * emits even while values keep arriving.
+ *
+ * The resulting observable:
+ * - Emits the latest value at the end of each period.
+ * - Emits the pending value and completes when the source completes.
+ * - Forwards errors from the source, dropping the pending value.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param duration The length of each period.
+ * @param scheduler The scheduler whose timers measure the periods.
+ * @return Operator<T, T> A function that applies the rate limit to an observable.
+ */
+template <typename T>
+Operator<T, T> auditTime(Scheduler::Duration duration, Scheduler scheduler) {
+    return [duration, scheduler](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<T>([duration, scheduler, sourceObservable](const Subscriber<T>& subscriber) {
+            using Limiter = impl::RateLimiter<T>;
+
+            auto limiter = Limiter::create(subscriber, scheduler, [](Limiter& limiter) {
+                limiter.emitPending();
+            });
+
+            return Limiter::subscribe(limiter, sourceObservable,
+                [duration](Limiter& limiter, const T& t) {
+                    limiter.pending = t;
+                    if (!limiter.timer.isPending()) {
+                        limiter.timer.rescheduleAfter(duration);
+                    }
+                },
+                [](Limiter& limiter) { limiter.emitPending(); }
+            );
+        });
+    };
+}
+
+/**
+ * @brief Collects values into batches of a fixed size.
+ *
+ * The `bufferCount` operator opens a new batch every `skip` values and emits it once it
+ * holds `count` values. With `skip == count` the batches are consecutive, with `skip < count`
+ * they overlap and with `skip > count` the values in between are dropped.
+ *
+ * Batch storage comes from `pool` and goes back there after `next` returns, so a batch is
+ * only valid during `next`. See `BatchPool` for keeping batches.
+ *
+ * The resulting observable:
+ * - Emits each batch as soon as it is full.
+ * - Emits the open, partially filled batches and completes when the source completes.
+ * - Forwards errors from the source, discarding open batches.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param count The number of values in a batch.
+ * @param skip The number of values after which a new batch is opened; defaults to `count`.
+ * @param pool The pool providing batch storage.
+ * @return Operator<T, std::vector<T>> A function that batches the values of an observable.
+ * @throws std::invalid_argument If `count` is zero.
+ */
+template <typename T>
+Operator<T, std::vector<T>> bufferCount(std::size_t count, std::size_t skip = 0, BatchPool<T> pool = BatchPool<T>()) {
+    skip = skip == 0 ? count : skip;
+    if (count == 0) {
+        throw std::invalid_argument("bufferCount: count must be positive");
+    }
+
+    return [count, skip, pool](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<std::vector<T>>([count, skip, pool, sourceObservable](const Subscriber<std::vector<T>>& subscriber) {
+            struct State {
+                std::vector<std::vector<T>> open;
+                std::size_t index = 0;
+            };
+
+            auto state = std::make_shared<State>();
+            state->open.reserve((count + skip - 1) / skip);
+
+            Observer<T> intermediateObserver(
+                [count, skip, pool, state, subscriber = subscriber.shared_from_this()](const T& t) {
+                    if (state->index++ % skip == 0) {
+                        state->open.push_back(pool.acquire(count));
+                    }
+
+                    for (std::vector<T>& batch : state->open) {
+                        batch.push_back(t);
+                    }
+
+                    if (!state->open.empty() && state->open.front().size() == count) {
+                        std::vector<T> batch = std::move(state->open.front());
+                        state->open.erase(state->open.begin());
+
+                        subscriber->next(batch);
+                        pool.recycle(std::move(batch));
+                    }
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    subscriber->error(err);
+                },
+                [pool, state, subscriber = subscriber.shared_from_this()]() {
+                    for (std::vector<T>& batch : state->open) {
+                        subscriber->next(batch);
+                        pool.recycle(std::move(batch));
+                    }
+
+                    state->open.clear();
+                    subscriber->complete();
+                }
+            );
+
+            return [subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Collects values into batches that are emitted periodically.
+ *
+ * The `bufferTime` operator emits the values collected during each `timespan` on
+ * `scheduler`. If `maxCount` is positive, a batch is also emitted as soon as it holds
+ * `maxCount` values, which starts a new time span. Empty batches are not emitted.
+ *
+ * A single timer is reused for all time spans. Batch storage comes from `pool` and goes
+ * back there after `next` returns, so a batch is only valid during `next`.
+ *
+ * The resulting observable:
+ * - Emits a batch at the end of each time span, or when it is full.
+ * - Emits the pending batch and completes when the source completes.
+ * - Forwards errors from the source, discarding the pending batch.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param timespan The length of the time span after which a batch is emitted.
+ * @param maxCount The maximum number of values in a batch, or `0` for no limit.
+ * @param scheduler The scheduler whose clock measures the time spans.
+ * @param pool The pool providing batch storage.
+ * @return Operator<T, std::vector<T>> A function that batches the values of an observable.
+ */
+template <typename T>
+Operator<T, std::vector<T>> bufferTime(Scheduler::Duration timespan, std::size_t maxCount, Scheduler scheduler, BatchPool<T> pool = BatchPool<T>()) {
+    return [timespan, maxCount, scheduler, pool](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<std::vector<T>>([timespan, maxCount, scheduler, pool, sourceObservable](const Subscriber<std::vector<T>>& subscriber) {
+            struct State {
+                const std::shared_ptr<const Subscriber<std::vector<T>>> subscriber;
+                const BatchPool<T> pool;
+                const std::size_t maxCount;
+                Timer timer;
+
+                // Recursive, as a consumer may feed the source from `next`
+                std::recursive_mutex mutex;
+                std::vector<T> batch;
+
+                State(std::shared_ptr<const Subscriber<std::vector<T>>> subscriber, BatchPool<T> pool, std::size_t maxCount)
+                    : subscriber(std::move(subscriber)), pool(std::move(pool)), maxCount(maxCount), batch(this->pool.acquire(maxCount)) {}
+
+                // Must be called with the mutex held
+                void flush() {
+                    if (batch.empty()) {
+                        return;
+                    }
+
+                    std::vector<T> full = std::exchange(batch, pool.acquire(maxCount));
+                    subscriber->next(full);
+                    pool.recycle(std::move(full));
+                }
+            };
+
+            auto state = std::make_shared<State>(subscriber.shared_from_this(), pool, maxCount);
+            std::weak_ptr<State> weakState = state;
+
+            state->timer = scheduler.createTimer([weakState, timespan]() {
+                if (auto state = weakState.lock()) {
+                    std::unique_lock lock(state->mutex);
+                    state->flush();
+                    state->timer.rescheduleAfter(timespan);
+                }
+            });
+            state->timer.rescheduleAfter(timespan);
+
+            Observer<T> intermediateObserver(
+                [state, timespan](const T& t) {
+                    std::unique_lock lock(state->mutex);
+                    state->batch.push_back(t);
+
+                    if (state->maxCount != 0 && state->batch.size() >= state->maxCount) {
+                        state->flush();
+                        state->timer.rescheduleAfter(timespan);
+                    }
+                },
+                [state](const std::exception_ptr& err) {
+                    std::unique_lock lock(state->mutex);
+                    state->timer.cancel();
+                    state->subscriber->error(err);
+                },
+                [state]() {
+                    std::unique_lock lock(state->mutex);
+                    state->timer.cancel();
+                    state->flush();
+                    state->subscriber->complete();
+                }
+            );
+
+            return [state, subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+                state->timer.cancel();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Collects values into batches that are emitted periodically.
+ *
+ * Equivalent to `bufferTime(timespan, 0, scheduler)`, i.e. batches are not limited in size.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param timespan The length of the time span after which a batch is emitted.
+ * @param scheduler The scheduler whose clock measures the time spans.
+ * @return Operator<T, std::vector<T>> A function that batches the values of an observable.
+ */
+template <typename T>
+Operator<T, std::vector<T>> bufferTime(Scheduler::Duration timespan, Scheduler scheduler) {
+    return bufferTime<T>(timespan, 0, std::move(scheduler));
+}
+
+/**
+ * @brief Collects values into batches that are emitted whenever a notifier emits.
+ *
+ * The `bufferWhen` operator collects the values of the source and emits them as a batch
+ * each time `closingNotifier` emits. Empty batches are not emitted.
+ *
+ * Batch storage comes from `pool` and goes back there after `next` returns, so a batch is
+ * only valid during `next`.
+ *
+ * The resulting observable:
+ * - Emits the collected values whenever the notifier emits.
+ * - Emits the pending batch and completes when the source completes.
+ * - Forwards errors from the source and the notifier, discarding the pending batch.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @tparam U The type of values emitted by the notifier.
+ * @param closingNotifier The observable whose values close the current batch.
+ * @param pool The pool providing batch storage.
+ * @return Operator<T, std::vector<T>> A function that batches the values of an observable.
+ */
+template <typename T, typename U>
+Operator<T, std::vector<T>> bufferWhen(Observable<U> closingNotifier, BatchPool<T> pool = BatchPool<T>()) {
+    return [closingNotifier, pool](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<std::vector<T>>([closingNotifier, pool, sourceObservable](const Subscriber<std::vector<T>>& subscriber) {
+            struct State {
+                // Recursive, as a consumer may feed the source from `next`
+                std::recursive_mutex mutex;
+                std::vector<T> batch;
+            };
+
+            auto state = std::make_shared<State>();
+            state->batch = pool.acquire();
+
+            auto flush = [pool, state, subscriber = subscriber.shared_from_this()]() {
+                if (state->batch.empty()) {
+                    return;
+                }
+
+                std::vector<T> full = std::exchange(state->batch, pool.acquire(state->batch.size()));
+                subscriber->next(full);
+                pool.recycle(std::move(full));
+            };
+
+            Subscription subscriptions;
+
+            subscriptions.add(closingNotifier.subscribe(Observer<U>(
+                [state, flush](const U&) {
+                    std::unique_lock lock(state->mutex);
+                    flush();
+                },
+                [state, subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    std::unique_lock lock(state->mutex);
+                    subscriber->error(err);
+                }
+            )));
+
+            subscriptions.add(sourceObservable.subscribe(Observer<T>(
+                [state](const T& t) {
+                    std::unique_lock lock(state->mutex);
+                    state->batch.push_back(t);
+                },
+                [state, subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    std::unique_lock lock(state->mutex);
+                    subscriber->error(err);
+                },
+                [state, flush, subscriber = subscriber.shared_from_this()]() {
+                    std::unique_lock lock(state->mutex);
+                    flush();
+                    subscriber->complete();
+                }
+            )));
+
+            return [subscriptions]() mutable {
+                subscriptions.unsubscribe();
+            };
+        });
+    };
+}
+
 /**
  * @brief Combines multiple observables and emits tuples containing the latest values.
  * 
@@ -110,119 +709,2635 @@ Operator<T, std::tuple<T, Us...>> combineLatest(Observable<Us>... latestObservab
 }
 
 /**
- * @brief Filters out duplicate values from an observable sequence.
- * 
- * The `distinct` operator ensures that only unique values are emitted by an observable.
- * It maintains an internal set of seen values and suppresses any value that has already
- * been emitted before.
- * 
- * This operator does **not** reset its state when the source completes; if the same
- * `Observable` is resubscribed, previously seen values will still be filtered out.
- * 
+ * @brief Combines a runtime number of observables of the same type into views of their latest values.
+ *
+ * Unlike the variadic `combineLatest` operator, `combineLatestN` takes a vector of
+ * observables, such as hundreds of sensor feeds, and creates an observable from them. The
+ * latest values are kept in one contiguous array, and a counter of sources that have not
+ * emitted yet makes the readiness check O(1). Each emission is a `std::span` over that array
+ * rather than a copy, where element `i` is the latest value of `observables[i]`; it is only
+ * valid during `next`.
+ *
+ * The sources may emit from different threads; emissions are serialized.
+ *
  * The resulting observable:
- * - Emits only distinct values from the source.
- * - Completes when the source completes.
- * - Forwards any errors from the source.
- * 
- * @tparam T The type of values emitted by the source observable.
- * @return Operator<T, T> A function that applies the distinct filtering logic to an observable.
+ * - Emits once every source has emitted, and on every value after that.
+ * - Completes when all sources have completed, or as soon as one completes without ever
+ *   emitting. Completes immediately if `observables` is empty.
+ * - Forwards errors from any source.
+ *
+ * @tparam T The type of values emitted by the observables; it must be default-constructible.
+ * @param observables The observables to combine.
+ * @return Observable<std::span<const T>> An observable of views of the latest values.
  */
 template <typename T>
-Operator<T, T> distinct() {
-    return [](const Observable<T>& sourceObservable) {
-        return impl::ObservableFactory<T>([sourceObservable](const Subscriber<T>& subscriber) {
-            std::unordered_set<T> seen;
+requires std::default_initializable<T>
+Observable<std::span<const T>> combineLatestN(std::vector<Observable<T>> observables) {
+    return impl::ObservableFactory<std::span<const T>>([observables = std::move(observables)](const Subscriber<std::span<const T>>& subscriber) -> TeardownLogic {
+        struct State {
+            const std::shared_ptr<const Subscriber<std::span<const T>>> subscriber;
 
-            Observer<T> intermediateObserver(
-                [seen = std::move(seen), subscriber = subscriber.shared_from_this()](const T& t) mutable {
-                    auto [_, inserted] = seen.emplace(t);
-                    if (inserted) {
-                        subscriber->next(t);
+            // Recursive, as a consumer may feed a source from `next`
+            std::recursive_mutex mutex;
+            std::vector<T> latest;
+            std::vector<bool> hasValue;
+            std::size_t missing;
+            std::size_t active;
+
+            State(std::shared_ptr<const Subscriber<std::span<const T>>> subscriber, std::size_t count)
+                : subscriber(std::move(subscriber)), latest(count), hasValue(count), missing(count), active(count) {}
+        };
+
+        auto state = std::make_shared<State>(subscriber.shared_from_this(), observables.size());
+        if (observables.empty()) {
+            subscriber.complete();
+            return []() {};
+        }
+
+        Subscription subscriptions;
+        for (std::size_t i = 0; i < observables.size(); i++) {
+            subscriptions.add(observables[i].subscribe(Observer<T>(
+                [state, i](const T& t) {
+                    std::unique_lock lock(state->mutex);
+                    state->latest[i] = t;
+
+                    if (!state->hasValue[i]) {
+                        state->hasValue[i] = true;
+                        state->missing--;
+                    }
+
+                    if (state->missing == 0) {
+                        state->subscriber->next(std::span<const T>(state->latest));
                     }
                 },
-                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { 
-                    subscriber->error(err); 
+                [state](const std::exception_ptr& err) {
+                    std::unique_lock lock(state->mutex);
+                    state->subscriber->error(err);
                 },
-                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
-            );
+                [state, i]() {
+                    std::unique_lock lock(state->mutex);
+                    state->active--;
 
-            return [subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
-                subscription.unsubscribe();
-            };
-        });
-    };
+                    // A source that completes without a value means nothing can ever be emitted
+                    if (state->active == 0 || !state->hasValue[i]) {
+                        state->subscriber->complete();
+                    }
+                }
+            )));
+        }
+
+        return [subscriptions]() mutable {
+            subscriptions.unsubscribe();
+        };
+    });
 }
 
 /**
- * @brief Filters out consecutive duplicate values from an observable sequence.
- * 
- * The `distinctUntilChanged` operator ensures that only values that are different 
- * from the previously emitted value are passed to the observer. Unlike `distinct()`, 
- * which filters all previously seen values, this operator only removes **consecutive** duplicates.
- * 
- * The first value from the source is always emitted. Afterwards, a new value is only 
- * emitted if it differs from the last emitted value.
- * 
- * The resulting observable:
- * - Emits values only if they differ from the previous emitted value.
- * - Completes when the source completes.
- * - Forwards any errors from the source.
- * 
- * @tparam T The type of values emitted by the source observable.
- * @return Operator<T, T> A function that applies the distinct-until-changed filtering logic to an observable.
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
  */
+namespace impl {
+
+// Serializes events from concurrent sources with a queue-drain loop.
+//
+// The first thread to deliver an event becomes the emitter; events that arrive from other
+// threads meanwhile, or re-entrantly from the subscriber, are queued, and the emitter
+// delivers them before it lets go. Nobody waits for the subscriber: the lock only guards
+// the queue. A terminal event is delivered after the values queued before it.
 template <typename T>
-Operator<T, T> distinctUntilChanged() {
-    return [](const Observable<T>& sourceObservable) {
-        return impl::ObservableFactory<T>([sourceObservable](const Subscriber<T>& subscriber) {
-            std::optional<T> lastValue;
+class SerializedEmitter {
+public:
+    explicit SerializedEmitter(std::shared_ptr<const Subscriber<T>> subscriber) : subscriber(std::move(subscriber)) {}
 
-            Observer<T> intermediateObserver(
-                [lastValue = std::move(lastValue), subscriber = subscriber.shared_from_this()](const T& t) mutable {
-                    if (!lastValue || *lastValue != t) { 
-                        subscriber->next(t);
-                        lastValue = t;
+    void next(const T& t) {
+        {
+            std::unique_lock lock(mutex);
+            if (terminated) {
+                return;
+            }
+
+            if (emitting) {
+                queue.push(t);
+                return;
+            }
+
+            emitting = true;
+        }
+
+        subscriber->next(t);
+        drain();
+    }
+
+    void error(const std::exception_ptr& err) {
+        terminate(err);
+    }
+
+    void complete() {
+        terminate(nullptr);
+    }
+
+private:
+    const std::shared_ptr<const Subscriber<T>> subscriber;
+
+    std::mutex mutex;
+    RingQueue<T> queue;
+    RingQueue<T> batch;
+    bool emitting = false;
+    bool terminated = false;
+    std::exception_ptr terminalError;
+
+    void terminate(const std::exception_ptr& err) {
+        {
+            std::unique_lock lock(mutex);
+            if (terminated) {
+                return;
+            }
+
+            terminated = true;
+            terminalError = err;
+
+            if (emitting) {
+                return;
+            }
+
+            emitting = true;
+        }
+
+        drain();
+    }
+
+    // Called by the emitter; delivers queued events until there are none left
+    void drain() {
+        for (;;) {
+            bool deliverTerminal;
+
+            {
+                std::unique_lock lock(mutex);
+                if (queue.empty()) {
+                    deliverTerminal = terminated;
+                    if (!deliverTerminal) {
+                        emitting = false;
+                        return;
                     }
-                },
-                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { 
-                    subscriber->error(err); 
-                },
-                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
-            );
+                } else {
+                    // Take the whole queue, so producers keep queueing while the batch is delivered
+                    std::swap(queue, batch);
+                    deliverTerminal = false;
+                }
+            }
 
-            return [subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
-                subscription.unsubscribe();
-            };
-        });
-    };
-}
+            if (deliverTerminal) {
+                if (terminalError) {
+                    subscriber->error(terminalError);
+                } else {
+                    subscriber->complete();
+                }
+                return;
+            }
 
-/**
+            while (!batch.empty()) {
+                subscriber->next(batch.pop());
+            }
+        }
+    }
+};
+
+template <typename U>
+U observableValueOf(const Observable<U>&);
+
+// The type of values of the observables returned by `Func`
+template <typename Func, typename T>
+using FlattenedValue = decltype(observableValueOf(std::declval<std::invoke_result_t<Func, const T&>>()));
+
+enum class FlattenStrategy {
+    Merge,   // Subscribe up to a limit of inner observables at once, queueing further values
+    Switch,  // Unsubscribe from the current inner observable when the next value arrives
+    Exhaust  // Ignore values while an inner observable is active
+};
+
+// The shared state of the flattening operators.
+//
+// Inner subscriptions live in a slot array: a finished slot goes on a free list and is
+// reused by the next inner observable, and a generation number per slot tells events of a
+// finished inner observable from those of its successor. With `Merge`, outer values that
+// exceed `maxConcurrent` wait in a ring buffer. Inner observables that complete right when
+// they are subscribed to start their successors from a loop rather than recursively.
+//
+// The lock only guards the slots and the queue: slots are claimed and released under it,
+// but `project` runs, inner observables are subscribed to and unsubscribed from, and events
+// go downstream outside of it, the latter serialized by a `SerializedEmitter`.
+template <typename T, typename U, typename Func, FlattenStrategy Strategy>
+class FlattenState : public std::enable_shared_from_this<FlattenState<T, U, Func, Strategy>> {
+public:
+    FlattenState(std::shared_ptr<const Subscriber<U>> subscriber, Func project, std::size_t maxConcurrent)
+        : emitter(std::move(subscriber)), project(std::move(project)), maxConcurrent(maxConcurrent) {
+        slots.reserve(maxConcurrent);
+    }
+
+    void next(const T& t) {
+        std::unique_lock lock(mutex);
+        if (done) {
+            return;
+        }
+
+        if constexpr (Strategy == FlattenStrategy::Merge) {
+            queue.push(t);
+            lock.unlock();
+            drain();
+        } else if constexpr (Strategy == FlattenStrategy::Switch) {
+            std::vector<Subscription> cancelled = releaseAll();
+            auto [index, generation] = claim();
+            lock.unlock();
+
+            for (Subscription& subscription : cancelled) {
+                subscription.unsubscribe();
+            }
+            subscribeInner(t, index, generation);
+        } else {
+            if (active > 0) {
+                return;
+            }
+
+            auto [index, generation] = claim();
+            lock.unlock();
+            subscribeInner(t, index, generation);
+        }
+    }
+
+    void error(const std::exception_ptr& err) {
+        std::vector<Subscription> cancelled;
+        {
+            std::unique_lock lock(mutex);
+            if (done) {
+                return;
+            }
+
+            done = true;
+            cancelled = releaseAll();
+            queue.clear();
+        }
+
+        for (Subscription& subscription : cancelled) {
+            subscription.unsubscribe();
+        }
+        emitter.error(err);
+    }
+
+    void complete() {
+        {
+            std::unique_lock lock(mutex);
+            outerCompleted = true;
+        }
+
+        completeIfDone();
+    }
+
+    void cancel() {
+        std::vector<Subscription> cancelled;
+        {
+            std::unique_lock lock(mutex);
+            done = true;
+            cancelled = releaseAll();
+            queue.clear();
+        }
+
+        for (Subscription& subscription : cancelled) {
+            subscription.unsubscribe();
+        }
+    }
+
+private:
+    struct Slot {
+        Subscription subscription;
+        std::uint64_t generation = 0;
+        bool active = false;
+    };
+
+    SerializedEmitter<U> emitter;
+    const Func project;
+    const std::size_t maxConcurrent;
+
+    std::mutex mutex;
+    std::vector<Slot> slots;
+    std::vector<std::size_t> freeSlots;
+    std::size_t active = 0;
+    RingQueue<T> queue;
+    bool draining = false;
+    bool outerCompleted = false;
+    bool done = false;
+
+    // Must be called with the mutex held, like the other helpers below up to `subscribeInner`
+    bool isCurrent(std::size_t index, std::uint64_t generation) const {
+        return !done && slots[index].active && slots[index].generation == generation;
+    }
+
+    bool hasCapacity() const {
+        return maxConcurrent == 0 || active < maxConcurrent;
+    }
+
+    // Takes a slot for an inner observable; returns its index and generation
+    std::pair<std::size_t, std::uint64_t> claim() {
+        std::size_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            index = slots.size();
+            slots.emplace_back();
+        }
+
+        slots[index].active = true;
+        active++;
+        return { index, ++slots[index].generation };
+    }
+
+    // Frees the slot; returns its subscription, which the caller unsubscribes after unlocking
+    Subscription release(std::size_t index) {
+        slots[index].active = false;
+        active--;
+        freeSlots.push_back(index);
+
+        // The slot must let go, or the inner subscriber would keep this state alive
+        Subscription subscription = slots[index].subscription;
+        slots[index].subscription = Subscription();
+        return subscription;
+    }
+
+    std::vector<Subscription> releaseAll() {
+        std::vector<Subscription> released;
+        for (std::size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].active) {
+                released.push_back(release(i));
+            }
+        }
+
+        return released;
+    }
+
+    // Subscribes to the inner observable of a claimed slot; called without the mutex held
+    void subscribeInner(const T& t, std::size_t index, std::uint64_t generation) {
+        Subscription subscription;
+        try {
+            subscription = std::invoke(project, t).subscribe(innerObserver(index, generation));
+        } catch (...) {
+            // The slot is released along with all others
+            error(std::current_exception());
+            return;
+        }
+
+        std::unique_lock lock(mutex);
+        if (isCurrent(index, generation)) {
+            slots[index].subscription = subscription;
+            return;
+        }
+
+        // The inner observable finished, or was cancelled, while it was subscribed to
+        lock.unlock();
+        subscription.unsubscribe();
+    }
+
+    Observer<U> innerObserver(std::size_t index, std::uint64_t generation) {
+        return Observer<U>(
+            [state = this->shared_from_this(), index, generation](const U& u) {
+                {
+                    std::unique_lock lock(state->mutex);
+                    if (!state->isCurrent(index, generation)) {
+                        return;
+                    }
+                }
+
+                state->emitter.next(u);
+            },
+            [state = this->shared_from_this(), index, generation](const std::exception_ptr& err) {
+                {
+                    std::unique_lock lock(state->mutex);
+                    if (!state->isCurrent(index, generation)) {
+                        return;
+                    }
+                }
+
+                state->error(err);
+            },
+            [state = this->shared_from_this(), index, generation]() {
+                Subscription finished;
+                {
+                    std::unique_lock lock(state->mutex);
+                    if (!state->isCurrent(index, generation)) {
+                        return;
+                    }
+
+                    finished = state->release(index);
+                }
+
+                finished.unsubscribe();
+                state->drain();
+                state->completeIfDone();
+            }
+        );
+    }
+
+    // Subscribes to queued values while there is capacity; only one thread drains at a time
+    void drain() {
+        if constexpr (Strategy == FlattenStrategy::Merge) {
+            {
+                std::unique_lock lock(mutex);
+                if (draining) {
+                    return;
+                }
+                draining = true;
+            }
+
+            for (;;) {
+                std::unique_lock lock(mutex);
+                if (done || queue.empty() || !hasCapacity()) {
+                    draining = false;
+                    return;
+                }
+
+                T t = queue.pop();
+                auto [index, generation] = claim();
+                lock.unlock();
+
+                subscribeInner(t, index, generation);
+            }
+        }
+    }
+
+    void completeIfDone() {
+        {
+            std::unique_lock lock(mutex);
+            if (done || !outerCompleted || active > 0 || !queue.empty()) {
+                return;
+            }
+            done = true;
+        }
+
+        emitter.complete();
+    }
+};
+
+// Applies a flattening strategy to the observables returned by `project`
+template <typename T, FlattenStrategy Strategy, typename Func, typename U = FlattenedValue<std::decay_t<Func>, T>>
+Operator<T, U> flatten(Func&& project, std::size_t maxConcurrent) {
+    return [project = std::forward<Func>(project), maxConcurrent](const Observable<T>& sourceObservable) {
+        return ObservableFactory<U>([project, maxConcurrent, sourceObservable](const Subscriber<U>& subscriber) {
+            using State = FlattenState<T, U, std::decay_t<Func>, Strategy>;
+            auto state = std::make_shared<State>(subscriber.shared_from_this(), project, maxConcurrent);
+
+            Observer<T> intermediateObserver(
+                [state](const T& t) { state->next(t); },
+                [state](const std::exception_ptr& err) { state->error(err); },
+                [state]() { state->complete(); }
+            );
+
+            return [state, subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+                state->cancel();
+            };
+        });
+    };
+}
+
+} // namespace impl
+
+/**
+ * @brief Maps each value to an observable and emits their values one observable after another.
+ *
+ * Equivalent to `mergeMap(project, 1)`: the observable of a value is only subscribed to once
+ * the observables of all previous values have completed, so the order of values is kept.
+ * Values that arrive meanwhile are queued.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param project A function returning the observable for a value.
+ * @return Operator<T, U> A function that applies the mapping and flattening to an observable.
+ */
+template <typename T, typename Func, typename U = impl::FlattenedValue<std::decay_t<Func>, T>>
+Operator<T, U> concatMap(Func&& project) {
+    return impl::flatten<T, impl::FlattenStrategy::Merge>(std::forward<Func>(project), 1);
+}
+
+/**
+ * @brief Coalesces values by key while the consumer on the scheduler is busy.
+ *
+ * The `conflateByKey` operator delivers values on `scheduler`, like `observeOn`, but does
+ * not queue every value. Values that arrive while delivery is pending or in progress are
+ * collected in a flat hash map that keeps only the latest value per key. Once the consumer
+ * is free, the collected values are emitted in the order their keys first arrived. A
+ * consumer that falls behind thus does work proportional to the number of distinct keys,
+ * not to the input rate.
+ *
+ * Two maps are swapped between the producer and the consumer, so that the producer keeps
+ * collecting while the consumer emits; once both have grown to the number of keys,
+ * conflation does not allocate.
+ *
+ * The resulting observable:
+ * - Emits the latest value of each key that changed since the previous delivery.
+ * - Completes after the pending values were emitted, when the source completes.
+ * - Forwards errors from the source after the pending values.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param keySelector A callable that returns the key of a value, which must be hashable.
+ * @param scheduler The scheduler on which values are delivered.
+ * @return Operator<T, T> A function that applies the conflation to an observable.
+ */
+template <typename T, typename Func, typename K = std::decay_t<std::invoke_result_t<Func, const T&>>>
+Operator<T, T> conflateByKey(Func&& keySelector, Scheduler scheduler) {
+    return [keySelector = std::forward<Func>(keySelector), scheduler](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<T>([keySelector, scheduler, sourceObservable](const Subscriber<T>& subscriber) {
+            struct State {
+                const std::shared_ptr<const Subscriber<T>> subscriber;
+                Timer drainTimer;
+
+                std::mutex mutex;
+                impl::FlatHashMap<K, T> pending;
+                bool scheduled = false;
+                bool done = false;
+                std::exception_ptr error;
+
+                // Only touched by the drain
+                impl::FlatHashMap<K, T> draining;
+
+                explicit State(std::shared_ptr<const Subscriber<T>> subscriber) : subscriber(std::move(subscriber)) {}
+
+                // Must be called with the mutex held
+                void schedule() {
+                    if (!std::exchange(scheduled, true)) {
+                        drainTimer.rescheduleAfter(Scheduler::Duration::zero());
+                    }
+                }
+
+                void drain() {
+                    for (;;) {
+                        {
+                            std::unique_lock lock(mutex);
+                            if (pending.empty()) {
+                                scheduled = false;
+                                if (!done) {
+                                    return;
+                                }
+                            }
+                            pending.swap(draining);
+                        }
+
+                        for (const auto& [_, value] : draining) {
+                            subscriber->next(value);
+                        }
+
+                        if (draining.empty()) {
+                            if (error) {
+                                subscriber->error(error);
+                            } else {
+                                subscriber->complete();
+                            }
+                            return;
+                        }
+
+                        draining.clear();
+                    }
+                }
+            };
+
+            auto state = std::make_shared<State>(subscriber.shared_from_this());
+            std::weak_ptr<State> weakState = state;
+
+            state->drainTimer = scheduler.createTimer([weakState]() {
+                if (auto state = weakState.lock()) {
+                    state->drain();
+                }
+            });
+
+            Observer<T> intermediateObserver(
+                [keySelector, state](const T& t) {
+                    std::unique_lock lock(state->mutex);
+                    state->pending.insertOrAssign(std::invoke(keySelector, t), t);
+                    state->schedule();
+                },
+                [state](const std::exception_ptr& err) {
+                    std::unique_lock lock(state->mutex);
+                    state->error = err;
+                    state->done = true;
+                    state->schedule();
+                },
+                [state]() {
+                    std::unique_lock lock(state->mutex);
+                    state->done = true;
+                    state->schedule();
+                }
+            );
+
+            return [state, subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+                state->drainTimer.cancel();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Emits a value only once no other value followed it for a period of time.
+ *
+ * Every value (re)starts a timer of `dueTime` and replaces the pending value; when the
+ * timer fires, the pending value is emitted. Bursts of values are thus reduced to their
+ * last value, once the burst is over. The same timer is moved for every value, so
+ * debouncing does not allocate, and the scheduler holds one pending timer per subscription
+ * however fast values arrive.
+ *
+ * The resulting observable:
+ * - Emits the last value of each burst, `dueTime` after it arrived.
+ * - Emits the pending value and completes when the source completes.
+ * - Forwards errors from the source, dropping the pending value.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param dueTime How long the source must be silent before the last value is emitted.
+ * @param scheduler The scheduler whose timers measure the silence.
+ * @return Operator<T, T> A function that applies the debouncing to an observable.
+ */
+template <typename T>
+Operator<T, T> debounceTime(Scheduler::Duration dueTime, Scheduler scheduler) {
+    return [dueTime, scheduler](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<T>([dueTime, scheduler, sourceObservable](const Subscriber<T>& subscriber) {
+            using Limiter = impl::RateLimiter<T>;
+
+            auto limiter = Limiter::create(subscriber, scheduler, [](Limiter& limiter) {
+                limiter.emitPending();
+            });
+
+            return Limiter::subscribe(limiter, sourceObservable,
+                [dueTime](Limiter& limiter, const T& t) {
+                    limiter.pending = t;
+                    limiter.timer.rescheduleAfter(dueTime);
+                },
+                [](Limiter& limiter) { limiter.emitPending(); }
+            );
+        });
+    };
+}
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// The keys seen by `distinct`, held in a flat hash map.
+//
+// If keys may be forgotten (`Forgets`), either because their number is bounded or because
+// they expire, each key carries the sequence number and time of its last sighting, and a queue
+// records the sightings in order. The front of the queue is the least recently seen key,
+// unless that key was seen again since; such stale records are skipped, and the queue is
+// rebuilt from the map once they make up most of it.
+template <typename K, typename Hash, typename KeyEqual, bool Forgets>
+class DistinctKeys {
+public:
+    DistinctKeys(std::size_t capacity, Scheduler::Duration ttl, Hash hash, KeyEqual equal)
+        : capacity(capacity), ttl(ttl), keys(capacity, std::move(hash), std::move(equal)) {}
+
+    // Remembers the key as seen at `now`; returns whether it was not remembered before
+    bool insert(const K& key, Scheduler::TimePoint now) {
+        if constexpr (!Forgets) {
+            return keys.tryEmplace(key).second;
+        } else {
+            return insertSighting(key, now);
+        }
+    }
+
+private:
+    struct Sighting {
+        std::uint64_t sequence;
+        Scheduler::TimePoint time;
+    };
+
+    struct Record {
+        K key;
+        std::uint64_t sequence;
+        Scheduler::TimePoint time;
+    };
+
+    // Keys that are never forgotten need no sightings
+    struct Unit {};
+
+    const std::size_t capacity;
+    const Scheduler::Duration ttl;
+    FlatHashMap<K, std::conditional_t<Forgets, Sighting, Unit>, Hash, KeyEqual> keys;
+    std::deque<Record> order;
+    std::uint64_t sightings = 0;
+
+    bool insertSighting(const K& key, Scheduler::TimePoint now) {
+        expire(now);
+
+        std::uint64_t sequence = ++sightings;
+        auto [sighting, inserted] = keys.tryEmplace(key, Sighting{ sequence, now });
+        if (!inserted) {
+            *sighting = Sighting{ sequence, now };
+        }
+        order.push_back({ key, sequence, now });
+
+        if (capacity != 0 && keys.size() > capacity) {
+            evictOldest();
+        }
+
+        if (order.size() > 2 * std::max<std::size_t>(keys.size(), 16)) {
+            rebuildOrder();
+        }
+
+        return inserted;
+    }
+
+    bool isStale(const Record& record) const {
+        const Sighting* sighting = keys.find(record.key);
+        return sighting == nullptr || sighting->sequence != record.sequence;
+    }
+
+    void expire(Scheduler::TimePoint now) {
+        while (!order.empty()) {
+            const Record& oldest = order.front();
+            if (!isStale(oldest)) {
+                if (ttl == Scheduler::Duration::zero() || now - oldest.time < ttl) {
+                    return;
+                }
+
+                keys.erase(oldest.key);
+            }
+
+            order.pop_front();
+        }
+    }
+
+    void evictOldest() {
+        while (isStale(order.front())) {
+            order.pop_front();
+        }
+
+        keys.erase(order.front().key);
+        order.pop_front();
+    }
+
+    void rebuildOrder() {
+        order.clear();
+        for (const auto& [key, sighting] : keys) {
+            order.push_back({ key, sighting.sequence, sighting.time });
+        }
+
+        std::sort(order.begin(), order.end(), [](const Record& a, const Record& b) { return a.sequence < b.sequence; });
+    }
+};
+
+template <typename T, typename K, bool Forgets, typename KeySelector, typename Hash, typename KeyEqual>
+Operator<T, T> distinct(KeySelector&& keySelector, std::size_t capacity, Scheduler::Duration ttl, std::optional<Scheduler> scheduler, Hash hash, KeyEqual equal) {
+    return [keySelector = std::forward<KeySelector>(keySelector), capacity, ttl, scheduler, hash, equal](const Observable<T>& sourceObservable) {
+        return ObservableFactory<T>([keySelector, capacity, ttl, scheduler, hash, equal, sourceObservable](const Subscriber<T>& subscriber) {
+            auto seen = std::make_shared<DistinctKeys<K, Hash, KeyEqual, Forgets>>(capacity, ttl, hash, equal);
+
+            Observer<T> intermediateObserver(
+                [keySelector, scheduler, seen, subscriber = subscriber.shared_from_this()](const T& t) {
+                    Scheduler::TimePoint now = scheduler ? scheduler->now() : Scheduler::TimePoint();
+                    if (seen->insert(std::invoke(keySelector, t), now)) {
+                        subscriber->next(t);
+                    }
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    subscriber->error(err);
+                },
+                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
+            );
+
+            return [subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+            };
+        });
+    };
+}
+
+} // namespace impl
+
+/**
+ * @brief Filters out duplicate values from an observable sequence.
+ * 
+ * The `distinct` operator ensures that only unique values are emitted by an observable.
+ * It maintains an internal set of seen values and suppresses any value that has already
+ * been emitted before. The set is an open-addressing hash set, so it stays compact for
+ * streams with many distinct values.
+ * 
+ * Each subscription keeps its own set, which grows with the number of distinct values;
+ * the overloads taking a capacity or a time to live bound it.
+ * 
+ * The resulting observable:
+ * - Emits only distinct values from the source.
+ * - Completes when the source completes.
+ * - Forwards any errors from the source.
+ * 
+ * @tparam T The type of values emitted by the source observable.
+ * @return Operator<T, T> A function that applies the distinct filtering logic to an observable.
+ */
+template <typename T>
+Operator<T, T> distinct() {
+    return impl::distinct<T, T, false>(std::identity(), 0, Scheduler::Duration::zero(), std::nullopt, std::hash<T>(), std::equal_to<T>());
+}
+
+/**
+ * @brief Filters out values whose key was seen before.
+ *
+ * Like `distinct()`, but compares the keys returned by `keySelector` using `hash` and
+ * `equal`, for example to deduplicate messages by their identifier.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param keySelector A function returning the key of a value.
+ * @param hash The hash function for keys.
+ * @param equal The equality of keys.
+ * @return Operator<T, T> A function that applies the distinct filtering logic to an observable.
+ */
+template <typename T, typename KeySelector, typename K = std::decay_t<std::invoke_result_t<KeySelector, const T&>>,
+          typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+requires std::is_invocable_v<const Hash&, const K&>
+Operator<T, T> distinct(KeySelector&& keySelector, Hash hash = Hash(), KeyEqual equal = KeyEqual()) {
+    return impl::distinct<T, K, false>(std::forward<KeySelector>(keySelector), 0, Scheduler::Duration::zero(), std::nullopt, std::move(hash), std::move(equal));
+}
+
+/**
+ * @brief Filters out values whose key is among the most recently seen keys.
+ *
+ * Like `distinct(keySelector)`, but remembers at most `capacity` keys. When a new key
+ * exceeds the capacity, the least recently seen key is forgotten, so a value with that key
+ * is emitted again should it come back. Seeing a key again, even in a suppressed value,
+ * counts as a sighting.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param keySelector A function returning the key of a value.
+ * @param capacity The maximum number of keys remembered, or `0` for no limit.
+ * @param hash The hash function for keys.
+ * @param equal The equality of keys.
+ * @return Operator<T, T> A function that applies the distinct filtering logic to an observable.
+ */
+template <typename T, typename KeySelector, typename K = std::decay_t<std::invoke_result_t<KeySelector, const T&>>,
+          typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+Operator<T, T> distinct(KeySelector&& keySelector, std::size_t capacity, Hash hash = Hash(), KeyEqual equal = KeyEqual()) {
+    if (capacity == 0) {
+        return distinct<T>(std::forward<KeySelector>(keySelector), std::move(hash), std::move(equal));
+    }
+
+    return impl::distinct<T, K, true>(std::forward<KeySelector>(keySelector), capacity, Scheduler::Duration::zero(), std::nullopt, std::move(hash), std::move(equal));
+}
+
+/**
+ * @brief Filters out values whose key was seen within a period of time.
+ *
+ * Like `distinct(keySelector, capacity)`, but additionally forgets a key once it has not
+ * been seen for `ttl`, as measured by `scheduler`. Expired keys are dropped lazily, as new
+ * values arrive.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param keySelector A function returning the key of a value.
+ * @param ttl How long a key is remembered after it was last seen.
+ * @param scheduler The scheduler whose clock measures the time to live.
+ * @param capacity The maximum number of keys remembered, or `0` for no limit.
+ * @param hash The hash function for keys.
+ * @param equal The equality of keys.
+ * @return Operator<T, T> A function that applies the distinct filtering logic to an observable.
+ */
+template <typename T, typename KeySelector, typename K = std::decay_t<std::invoke_result_t<KeySelector, const T&>>,
+          typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+Operator<T, T> distinct(KeySelector&& keySelector, Scheduler::Duration ttl, Scheduler scheduler, std::size_t capacity = 0, Hash hash = Hash(), KeyEqual equal = KeyEqual()) {
+    return impl::distinct<T, K, true>(std::forward<KeySelector>(keySelector), capacity, ttl, std::move(scheduler), std::move(hash), std::move(equal));
+}
+
+namespace impl {
+
+class DistinctApproxFilter;
+
+} // namespace impl
+
+/**
+ * @brief Counters of a `distinctApprox` operator.
+ *
+ * Copies of a `DistinctApproxStats` share the same counters, so a copy passed to
+ * `distinctApprox()` can be read from elsewhere. The value counters add up all
+ * subscriptions of the operator, while the fill covers the filters still in use: a
+ * filter leaves it once the source releases its unsubscribed observer.
+ */
+class DistinctApproxStats {
+public:
+    DistinctApproxStats() : counters(std::make_shared<Counters>()) {}
+
+    /**
+     * @brief Returns the number of values that were emitted.
+     */
+    std::uint64_t emitted() const {
+        return counters->emitted.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the number of values that were suppressed, including false positives.
+     */
+    std::uint64_t suppressed() const {
+        return counters->suppressed.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the fraction of filter bits that are set, over the filters in use.
+     */
+    double fill() const {
+        std::uint64_t bits = counters->bits.load(std::memory_order_relaxed);
+        return bits == 0 ? 0.0 : static_cast<double>(counters->setBits.load(std::memory_order_relaxed)) / static_cast<double>(bits);
+    }
+
+    /**
+     * @brief Estimates the probability that the next new value is suppressed by mistake.
+     *
+     * The estimate assumes the set bits are spread evenly, so it rises from zero towards one
+     * as the filter fills up; it exceeds the configured rate once more values than expected
+     * were seen.
+     */
+    double falsePositiveRate() const {
+        return std::pow(fill(), 8);
+    }
+
+private:
+    struct Counters {
+        std::atomic<std::uint64_t> emitted = 0;
+        std::atomic<std::uint64_t> suppressed = 0;
+        std::atomic<std::uint64_t> setBits = 0;
+        std::atomic<std::uint64_t> bits = 0;
+    };
+
+    std::shared_ptr<Counters> counters;
+
+    friend class impl::DistinctApproxFilter;
+};
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// The Bloom filter of one `distinctApprox` subscription, reporting to the shared counters
+class DistinctApproxFilter {
+public:
+    DistinctApproxFilter(std::size_t expectedItems, double falsePositiveRate, DistinctApproxStats stats)
+        : filter(expectedItems, falsePositiveRate), stats(std::move(stats)) {
+        this->stats.counters->bits.fetch_add(filter.bitCount(), std::memory_order_relaxed);
+    }
+
+    // Takes the bits of this filter back out of the fill
+    ~DistinctApproxFilter() {
+        stats.counters->setBits.fetch_sub(setBits, std::memory_order_relaxed);
+        stats.counters->bits.fetch_sub(filter.bitCount(), std::memory_order_relaxed);
+    }
+
+    DistinctApproxFilter(const DistinctApproxFilter&) = delete;
+    DistinctApproxFilter& operator=(const DistinctApproxFilter&) = delete;
+
+    // Returns whether the hash was not seen before
+    bool insert(std::uint64_t hash) {
+        // Standard hashes of integers are the identity, so mix all bits into both halves
+        hash = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdull;
+        hash = (hash ^ (hash >> 33)) * 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+
+        std::size_t newlySet = filter.insert(hash);
+        if (newlySet == 0) {
+            stats.counters->suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        setBits += newlySet;
+        stats.counters->setBits.fetch_add(newlySet, std::memory_order_relaxed);
+        stats.counters->emitted.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    BlockedBloomFilter filter;
+    const DistinctApproxStats stats;
+    std::uint64_t setBits = 0;
+};
+
+} // namespace impl
+
+/**
+ * @brief Filters out duplicate values using a fixed amount of memory.
+ *
+ * Like `distinct()`, but remembers values in a Bloom filter instead of a set, so memory
+ * is sized up front from `expectedItems` and `falsePositiveRate` and does not grow: about
+ * 10 bits per expected item for a 1% rate. In exchange, a new value is suppressed with a
+ * small probability, the false positive rate, which rises once more than `expectedItems`
+ * distinct values were seen. Duplicates are always suppressed.
+ *
+ * Each value costs one hash and a single cache line access. The fill of the filter and
+ * the resulting false positive rate can be watched through `stats`.
+ *
+ * The resulting observable:
+ * - Emits values the filter has not seen before.
+ * - Completes when the source completes.
+ * - Forwards any errors from the source.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @tparam Hash The hash function for values.
+ * @param expectedItems The number of distinct values the filter is sized for.
+ * @param falsePositiveRate The acceptable probability of suppressing a new value, in (0, 1).
+ * @param stats The counters of the filter.
+ * @param hash The hash function for values.
+ * @return Operator<T, T> A function that applies the approximate distinct filtering to an observable.
+ * @throws std::invalid_argument If `expectedItems` is zero or `falsePositiveRate` is not in (0, 1).
+ */
+template <typename T, typename Hash = std::hash<T>>
+Operator<T, T> distinctApprox(std::size_t expectedItems, double falsePositiveRate, DistinctApproxStats stats = DistinctApproxStats(), Hash hash = Hash()) {
+    // Validates the arguments before any subscription
+    impl::BlockedBloomFilter::validate(expectedItems, falsePositiveRate);
+
+    return [expectedItems, falsePositiveRate, stats, hash](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<T>([expectedItems, falsePositiveRate, stats, hash, sourceObservable](const Subscriber<T>& subscriber) {
+            auto filter = std::make_shared<impl::DistinctApproxFilter>(expectedItems, falsePositiveRate, stats);
+
+            Observer<T> intermediateObserver(
+                [filter, hash, subscriber = subscriber.shared_from_this()](const T& t) {
+                    if (filter->insert(static_cast<std::uint64_t>(hash(t)))) {
+                        subscriber->next(t);
+                    }
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    subscriber->error(err);
+                },
+                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
+            );
+
+            return [subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// Keeps only the key of the last emitted value, so comparing costs O(key) rather than O(T)
+template <typename T, typename K, typename KeySelector, typename KeyEqual>
+Operator<T, T> distinctUntilChanged(KeySelector&& keySelector, KeyEqual&& equal) {
+    return [keySelector = std::forward<KeySelector>(keySelector), equal = std::forward<KeyEqual>(equal)](const Observable<T>& sourceObservable) {
+        return ObservableFactory<T>([keySelector, equal, sourceObservable](const Subscriber<T>& subscriber) {
+            std::optional<K> lastKey;
+
+            Observer<T> intermediateObserver(
+                [keySelector, equal, lastKey = std::move(lastKey), subscriber = subscriber.shared_from_this()](const T& t) mutable {
+                    decltype(auto) key = std::invoke(keySelector, t);
+                    if (lastKey && std::invoke(equal, std::as_const(*lastKey), std::as_const(key))) {
+                        return;
+                    }
+
+                    // Assigning reuses the storage of the previous key
+                    if (lastKey) {
+                        *lastKey = std::forward<decltype(key)>(key);
+                    } else {
+                        lastKey.emplace(std::forward<decltype(key)>(key));
+                    }
+
+                    subscriber->next(t);
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    subscriber->error(err);
+                },
+                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
+            );
+
+            return [subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+            };
+        });
+    };
+}
+
+} // namespace impl
+
+/**
+ * @brief Filters out consecutive duplicate values from an observable sequence.
+ * 
+ * The `distinctUntilChanged` operator ensures that only values that are different 
+ * from the previously emitted value are passed to the observer. Unlike `distinct()`, 
+ * which filters all previously seen values, this operator only removes **consecutive** duplicates.
+ * 
+ * The first value from the source is always emitted. Afterwards, a new value is only 
+ * emitted if it differs from the last emitted value.
+ * 
+ * The resulting observable:
+ * - Emits values only if they differ from the previous emitted value.
+ * - Completes when the source completes.
+ * - Forwards any errors from the source.
+ * 
+ * @tparam T The type of values emitted by the source observable.
+ * @return Operator<T, T> A function that applies the distinct-until-changed filtering logic to an observable.
+ */
+template <typename T>
+Operator<T, T> distinctUntilChanged() {
+    return impl::distinctUntilChanged<T, T>(std::identity(), std::equal_to<T>());
+}
+
+/**
+ * @brief Filters out consecutive values that a comparator considers equal.
+ *
+ * Like `distinctUntilChanged()`, but compares the last emitted value and the new one
+ * with `comparator` instead of `==`.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param comparator A function returning whether the previous and the new value are equal.
+ * @return Operator<T, T> A function that applies the distinct-until-changed filtering logic to an observable.
+ */
+template <typename T, typename Comparator>
+requires std::predicate<const Comparator&, const T&, const T&>
+Operator<T, T> distinctUntilChanged(Comparator&& comparator) {
+    return impl::distinctUntilChanged<T, T>(std::identity(), std::forward<Comparator>(comparator));
+}
+
+/**
+ * @brief Filters out consecutive values with equal keys.
+ *
+ * Like `distinctUntilChanged()`, but only keeps and compares the key returned by
+ * `keySelector`, such as the version of a large record, so neither the value is copied
+ * nor compared as a whole.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param keySelector A function returning the key of a value.
+ * @param equal The equality of keys.
+ * @return Operator<T, T> A function that applies the distinct-until-changed filtering logic to an observable.
+ */
+template <typename T, typename KeySelector, typename K = std::decay_t<std::invoke_result_t<KeySelector, const T&>>, typename KeyEqual = std::equal_to<K>>
+requires (!std::predicate<const KeySelector&, const T&, const T&>)
+Operator<T, T> distinctUntilChanged(KeySelector&& keySelector, KeyEqual equal = KeyEqual()) {
+    return impl::distinctUntilChanged<T, K>(std::forward<KeySelector>(keySelector), std::move(equal));
+}
+
+/**
+ * @brief Maps each value to an observable, ignoring values while the current observable is active.
+ *
+ * The `exhaustMap` operator subscribes to the observable returned by `project` for a value
+ * only if no observable of an earlier value is still active; otherwise the value is dropped.
+ * This suits requests that should not be repeated while one is in flight.
+ *
+ * The resulting observable:
+ * - Emits the values of the active inner observable.
+ * - Completes when the source and the active inner observable have completed.
+ * - Forwards errors from the source and the inner observables.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param project A function returning the observable for a value.
+ * @return Operator<T, U> A function that applies the mapping and flattening to an observable.
+ */
+template <typename T, typename Func, typename U = impl::FlattenedValue<std::decay_t<Func>, T>>
+Operator<T, U> exhaustMap(Func&& project) {
+    return impl::flatten<T, impl::FlattenStrategy::Exhaust>(std::forward<Func>(project), 1);
+}
+
+/**
+ * @brief An observable of the values of one group of `groupBy`, along with the group's key.
+ *
+ * @tparam K The type of the key.
+ * @tparam T The type of values in the group.
+ */
+template <typename K, typename T>
+class GroupedObservable : public Observable<T> {
+public:
+    GroupedObservable(K key, Observable<T> observable)
+        : Observable<T>(std::move(observable)), groupKey(std::move(key)) {}
+
+    /**
+     * @brief Returns the key shared by the values of this group.
+     */
+    const K& key() const {
+        return groupKey;
+    }
+
+private:
+    K groupKey;
+};
+
+/**
+ * @brief Configures where `groupBy` delivers its groups and when it forgets them.
+ */
+struct GroupByConfig {
+    /**
+     * @brief The schedulers the groups are delivered on.
+     *
+     * Each group is pinned to one of them, chosen by the hash of its key, so groups on
+     * different workers are processed in parallel while the values of a group keep their
+     * order. Empty delivers every group on the thread of the source.
+     */
+    std::vector<Scheduler> workers;
+
+    /**
+     * @brief Completes and forgets a group that received no values for this long.
+     *
+     * Zero keeps every group until the source terminates. Requires `scheduler`.
+     */
+    Scheduler::Duration idleTimeout = Scheduler::Duration::zero();
+
+    /**
+     * @brief The scheduler whose clock and timer expire idle groups.
+     */
+    std::optional<Scheduler> scheduler;
+};
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// A key along with its hash, which is computed once per value
+template <typename K>
+struct HashedKey {
+    K key;
+    std::size_t hash;
+};
+
+// Lets the group index rehash and shift entries without hashing keys again
+template <typename K>
+struct HashedKeyHash {
+    std::size_t operator()(const HashedKey<K>& hashed) const {
+        return hashed.hash;
+    }
+};
+
+// Compares the cached hashes first, so probing past other keys rarely compares keys
+template <typename K, typename KeyEqual>
+struct HashedKeyEqual {
+    KeyEqual equal;
+
+    bool operator()(const HashedKey<K>& a, const HashedKey<K>& b) const {
+        return a.hash == b.hash && equal(a.key, b.key);
+    }
+};
+
+// The shared state of `groupBy`.
+//
+// Groups are subjects indexed by an open-addressing hash map. Idle groups are expired by a
+// single timer that sweeps all groups and is then rescheduled for the earliest remaining
+// expiry, but at least an eighth of the timeout later, so sweeps stay rare however many
+// groups there are.
+template <typename K, typename T, typename Hash, typename KeyEqual>
+class GroupByState : public std::enable_shared_from_this<GroupByState<K, T, Hash, KeyEqual>> {
+public:
+    using Output = GroupedObservable<K, T>;
+
+    GroupByState(std::shared_ptr<const Subscriber<Output>> subscriber, GroupByConfig config, Hash hash, KeyEqual equal)
+        : subscriber(std::move(subscriber)), config(std::move(config)), hash(std::move(hash)),
+          groups(0, HashedKeyHash<K>(), HashedKeyEqual<K, KeyEqual>{ std::move(equal) }) {}
+
+    static std::shared_ptr<GroupByState> create(const Subscriber<Output>& subscriber, GroupByConfig config, Hash hash, KeyEqual equal) {
+        auto state = std::make_shared<GroupByState>(subscriber.shared_from_this(), std::move(config), std::move(hash), std::move(equal));
+
+        if (state->config.idleTimeout != Scheduler::Duration::zero()) {
+            state->sweepTimer = state->config.scheduler->createTimer([weakState = std::weak_ptr<GroupByState>(state)]() {
+                if (auto state = weakState.lock()) {
+                    state->sweep();
+                }
+            });
+        }
+
+        return state;
+    }
+
+    void next(K key, const T& t) {
+        std::unique_lock lock(mutex);
+        if (done) {
+            return;
+        }
+
+        std::size_t keyHash = hash(key);
+        HashedKey<K> hashed{ std::move(key), keyHash };
+        Scheduler::TimePoint now = sweepTimer ? config.scheduler->now() : Scheduler::TimePoint();
+
+        // Shared, as the subscriber may open other groups and thus move the entries
+        std::shared_ptr<Subject<T>> subject;
+        if (Group* group = groups.find(hashed)) {
+            group->lastSeen = now;
+            subject = group->subject;
+        } else {
+            subject = openGroup(hashed, now);
+            subscriber->next(Output(hashed.key, *subject));
+        }
+
+        subject->next(t);
+    }
+
+    void error(const std::exception_ptr& err) {
+        std::unique_lock lock(mutex);
+        if (done) {
+            return;
+        }
+
+        for (const Group& group : closeAll()) {
+            group.subject->error(err);
+        }
+        subscriber->error(err);
+    }
+
+    void complete() {
+        std::unique_lock lock(mutex);
+        if (done) {
+            return;
+        }
+
+        for (const Group& group : closeAll()) {
+            group.subject->complete();
+        }
+        subscriber->complete();
+    }
+
+    void cancel() {
+        std::unique_lock lock(mutex);
+        done = true;
+        if (sweepTimer) {
+            sweepTimer->cancel();
+        }
+    }
+
+private:
+    struct Group {
+        std::shared_ptr<Subject<T>> subject;
+        Scheduler::TimePoint lastSeen;
+    };
+
+    const std::shared_ptr<const Subscriber<Output>> subscriber;
+    const GroupByConfig config;
+    const Hash hash;
+
+    // Recursive, as subscribers may push values into the source while handling a group
+    std::recursive_mutex mutex;
+    FlatHashMap<HashedKey<K>, Group, HashedKeyHash<K>, HashedKeyEqual<K, KeyEqual>> groups;
+    std::optional<Timer> sweepTimer;
+    bool done = false;
+
+    std::shared_ptr<Subject<T>> openGroup(const HashedKey<K>& hashed, Scheduler::TimePoint now) {
+        auto subject = config.workers.empty()
+            ? std::make_shared<Subject<T>>()
+            : std::make_shared<Subject<T>>(config.workers[hashed.hash % config.workers.size()]);
+        groups.tryEmplace(hashed, Group{ subject, now });
+
+        if (sweepTimer && !sweepTimer->isPending()) {
+            sweepTimer->rescheduleAfter(config.idleTimeout);
+        }
+
+        return subject;
+    }
+
+    // Ends the operator, returning the open groups so they can be terminated
+    std::vector<Group> closeAll() {
+        done = true;
+        if (sweepTimer) {
+            sweepTimer->cancel();
+        }
+
+        std::vector<Group> closed;
+        closed.reserve(groups.size());
+        for (auto& [hashed, group] : groups) {
+            closed.push_back(std::move(group));
+        }
+
+        groups.clear();
+        return closed;
+    }
+
+    void sweep() {
+        std::unique_lock lock(mutex);
+        if (done) {
+            return;
+        }
+
+        Scheduler::TimePoint now = config.scheduler->now();
+        Scheduler::TimePoint nextExpiry = Scheduler::TimePoint::max();
+
+        std::vector<HashedKey<K>> expired;
+        for (const auto& [hashed, group] : groups) {
+            Scheduler::TimePoint expiry = group.lastSeen + config.idleTimeout;
+            if (expiry <= now) {
+                expired.push_back(hashed);
+            } else {
+                nextExpiry = std::min(nextExpiry, expiry);
+            }
+        }
+
+        for (const HashedKey<K>& hashed : expired) {
+            std::shared_ptr<Subject<T>> subject = groups.find(hashed)->subject;
+            groups.erase(hashed);
+            subject->complete();
+        }
+
+        if (!groups.empty()) {
+            sweepTimer->reschedule(std::max(nextExpiry, now + config.idleTimeout / 8));
+        }
+    }
+};
+
+} // namespace impl
+
+/**
+ * @brief Splits an observable into one observable per key.
+ *
+ * The `groupBy` operator emits a `GroupedObservable` for each new key returned by
+ * `keySelector` and routes every value into the group of its key. Subscribers of a group
+ * receive the values that arrive after they subscribe, so groups should be subscribed to
+ * right when they are emitted. Groups are looked up in an open-addressing hash map that
+ * caches the hash of each key.
+ *
+ * With `GroupByConfig::workers`, each group delivers its values on the worker chosen by
+ * the hash of its key: different keys are processed in parallel, and the values of one key
+ * keep their order. With `GroupByConfig::idleTimeout`, a group that receives no values for
+ * that long completes and is forgotten, so high-cardinality keys do not accumulate groups;
+ * a later value with the same key opens and emits a new group. Expiry may be up to an
+ * eighth of the timeout late.
+ *
+ * The resulting observable:
+ * - Emits a group for each key that has no open group.
+ * - Completes all groups, then itself, when the source completes.
+ * - Forwards errors from the source to all groups, then to its subscribers.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param keySelector A function returning the key of a value.
+ * @param config Where groups are delivered and when idle groups expire.
+ * @param hash The hash function of the keys.
+ * @param equal The equality comparison of the keys.
+ * @return Operator<T, GroupedObservable<K, T>> A function that groups an observable.
+ * @throws std::invalid_argument If an idle timeout is set without a scheduler, or is negative.
+ */
+template <typename T, typename KeySelector,
+          typename K = std::decay_t<std::invoke_result_t<KeySelector, const T&>>,
+          typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+Operator<T, GroupedObservable<K, T>> groupBy(KeySelector&& keySelector, GroupByConfig config = GroupByConfig(), Hash hash = Hash(), KeyEqual equal = KeyEqual()) {
+    if (config.idleTimeout < Scheduler::Duration::zero() || (config.idleTimeout != Scheduler::Duration::zero() && !config.scheduler)) {
+        throw std::invalid_argument("groupBy: an idle timeout must be positive and needs a scheduler");
+    }
+
+    using Output = GroupedObservable<K, T>;
+
+    return [keySelector = std::forward<KeySelector>(keySelector), config, hash, equal](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<Output>([keySelector, config, hash, equal, sourceObservable](const Subscriber<Output>& subscriber) {
+            auto state = impl::GroupByState<K, T, Hash, KeyEqual>::create(subscriber, config, hash, equal);
+
+            Observer<T> intermediateObserver(
+                [keySelector, state](const T& t) { state->next(std::invoke(keySelector, t), t); },
+                [state](const std::exception_ptr& err) { state->error(err); },
+                [state]() { state->complete(); }
+            );
+
+            return [state, subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+                state->cancel();
+            };
+        });
+    };
+}
+
+/**
  * @brief Transforms values emitted by an observable using a mapping function.
  * 
- * The `map` function applies `mapFunc` to each value emitted by the source observable,
- * producing a new observable of type `U`. It supports any callable, including 
- * function pointers, lambdas, and functors, without unnecessary heap allocations.
+ * The `map` function applies `mapFunc` to each value emitted by the source observable,
+ * producing a new observable of type `U`. It supports any callable, including 
+ * function pointers, lambdas, and functors, without unnecessary heap allocations.
+ * 
+ * Errors and completion signals from the source observable are properly propagated 
+ * to the resulting observable.
+ * 
+ * @tparam T The input value type.
+ * @param mapFunc A callable that transforms values of type `T` to an output type `U` (deduced automatically).
+ * @return Operator<T, U> A function that applies the transformation to an observable.
+ */
+template <typename T, typename Func, typename U = std::invoke_result_t<Func, const T&>>
+Operator<T, U> map(Func&& mapFunc) {
+    return [mapFunc = std::forward<Func>(mapFunc)](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<U>([mapFunc, sourceObservable](const Subscriber<U>& subscriber) {
+            Observer<T> intermediateObserver(
+                [mapFunc, subscriber = subscriber.shared_from_this()](const T& t) {
+                    subscriber->next(std::invoke(mapFunc, t));
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { 
+                    subscriber->error(err); 
+                },
+                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
+            );
+
+            return [subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Merges multiple observables of the same value type into a single observable stream.
+ * 
+ * The `merge` function takes multiple observables that emit values of type `T` and 
+ * combines them into a single observable. All values emitted by the source observable 
+ * and the additional input observables will be forwarded to the same downstream subscriber.
  * 
- * Errors and completion signals from the source observable are properly propagated 
- * to the resulting observable.
+ * Completion occurs when all upstream observables complete. Errors are forwarded immediately.
  * 
- * @tparam T The input value type.
- * @param mapFunc A callable that transforms values of type `T` to an output type `U` (deduced automatically).
- * @return Operator<T, U> A function that applies the transformation to an observable.
+ * @tparam T The common value type emitted by all observables.
+ * @tparam Ts Variadic list of types, all of which must be `T`.
+ * @param observables One or more observables that emit values of type `T`.
+ * @return Operator<T, T> A function that, when applied to an observable, produces a merged observable stream.
+ */
+template <typename T, typename... Ts>
+requires(std::is_same_v<T, Ts> && ...)
+Operator<T, T> merge(const Observable<Ts>&... observables) {
+    return [observables...](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<T>([sourceObservable, observables...](const Subscriber<T>& subscriber) {
+            const std::size_t totalSources = sizeof...(Ts) + 1;
+            auto completedCounter = std::make_shared<std::atomic<size_t>>(0);
+
+            Observer<T> intermediateObserver(
+                [subscriber = subscriber.shared_from_this()](const T& t) {
+                    subscriber->next(t);
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { 
+                    subscriber->error(err); 
+                },
+                [subscriber = subscriber.shared_from_this(), completedCounter, totalSources]() {
+                    // Sources may complete on different threads
+                    if (completedCounter->fetch_add(1, std::memory_order_acq_rel) + 1 == totalSources) {
+                        subscriber->complete();
+                    }
+                }
+            );
+
+            Subscription subscription = sourceObservable.subscribe(intermediateObserver);
+            (subscription.add(observables.subscribe(intermediateObserver)), ...);
+
+            return [subscription]() mutable {
+                subscription.unsubscribe();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Merges a runtime number of observables of the same type into a single observable.
+ *
+ * Unlike the variadic `merge` operator, `mergeAll` takes a vector of observables, such as
+ * per-connection streams created at runtime, and creates an observable from them. The
+ * sources may emit and complete on different threads: their events are delivered one at a
+ * time through a queue-drain loop, so the subscriber is never called concurrently, and
+ * completions are counted atomically.
+ *
+ * The resulting observable:
+ * - Emits the values of all observables as they arrive.
+ * - Completes when all observables have completed, or immediately if there are none.
+ * - Forwards the first error from any observable.
+ *
+ * @tparam T The type of values emitted by the observables.
+ * @param observables The observables to merge.
+ * @return Observable<T> An observable of the values of all observables.
+ */
+template <typename T>
+Observable<T> mergeAll(std::vector<Observable<T>> observables) {
+    return impl::ObservableFactory<T>([observables = std::move(observables)](const Subscriber<T>& subscriber) -> TeardownLogic {
+        if (observables.empty()) {
+            subscriber.complete();
+            return []() {};
+        }
+
+        auto emitter = std::make_shared<impl::SerializedEmitter<T>>(subscriber.shared_from_this());
+        auto remaining = std::make_shared<std::atomic<std::size_t>>(observables.size());
+
+        Observer<T> intermediateObserver(
+            [emitter](const T& t) { emitter->next(t); },
+            [emitter](const std::exception_ptr& err) { emitter->error(err); },
+            [emitter, remaining]() {
+                if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    emitter->complete();
+                }
+            }
+        );
+
+        Subscription subscriptions;
+        for (const Observable<T>& observable : observables) {
+            subscriptions.add(observable.subscribe(intermediateObserver));
+        }
+
+        return [subscriptions]() mutable {
+            subscriptions.unsubscribe();
+        };
+    });
+}
+
+/**
+ * @brief Maps each value to an observable and merges the values of these observables.
+ *
+ * The `mergeMap` operator subscribes to the observable returned by `project` for each value
+ * of the source and emits the values of all of them as they arrive. At most `maxConcurrent`
+ * inner observables are subscribed to at once; values beyond that are queued and mapped once
+ * an inner observable completes, which bounds the number of operations in flight.
+ *
+ * Inner observables may emit on any thread; emissions are serialized.
+ *
+ * The resulting observable:
+ * - Emits the values of all inner observables.
+ * - Completes when the source and all inner observables have completed.
+ * - Forwards errors from the source and the inner observables, unsubscribing from the others.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param project A function returning the observable for a value.
+ * @param maxConcurrent The maximum number of inner observables subscribed to at once, or `0` for no limit.
+ * @return Operator<T, U> A function that applies the mapping and flattening to an observable.
+ */
+template <typename T, typename Func, typename U = impl::FlattenedValue<std::decay_t<Func>, T>>
+Operator<T, U> mergeMap(Func&& project, std::size_t maxConcurrent = 0) {
+    return impl::flatten<T, impl::FlattenStrategy::Merge>(std::forward<Func>(project), maxConcurrent);
+}
+
+/**
+ * @brief Re-emits all notifications from the source observable on the given scheduler.
+ * 
+ * The `observeOn` operator hands every value, error and completion signal of the source 
+ * observable to `scheduler` and forwards it to the downstream subscriber from there. The 
+ * order of notifications is preserved as long as the scheduler runs actions in the order 
+ * they were scheduled, which all RxLite schedulers do for actions that are due immediately.
+ * 
+ * Combined with a `TrampolineScheduler`, this bounds the stack depth of re-entrant 
+ * emissions, e.g. an observer that pushes new values into its own source from `next`.
+ * 
+ * @tparam T The type of values emitted by the source observable.
+ * @param scheduler The scheduler on which notifications are delivered.
+ * @return Operator<T, T> A function that moves the delivery of an observable onto the scheduler.
+ */
+template <typename T>
+Operator<T, T> observeOn(Scheduler scheduler) {
+    return [scheduler](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<T>([scheduler, sourceObservable](const Subscriber<T>& subscriber) {
+            Observer<T> intermediateObserver(
+                [scheduler, subscriber = subscriber.shared_from_this()](const T& t) {
+                    scheduler.dispatch([subscriber, t]() { subscriber->next(t); });
+                },
+                [scheduler, subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { 
+                    scheduler.dispatch([subscriber, err]() { subscriber->error(err); });
+                },
+                [scheduler, subscriber = subscriber.shared_from_this()]() { 
+                    scheduler.dispatch([subscriber]() { subscriber->complete(); });
+                }
+            );
+
+            return [subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+            };
+        });
+    };
+}
+
+/**
+ * @brief What `rateLimit` does with values that exceed the rate.
+ */
+enum class RateLimitPolicy {
+    Delay, ///< Queue excess values and emit them, in order, as tokens become available.
+    Drop,  ///< Discard excess values.
+    Batch  ///< Collect excess values and emit them together, as one batch, for the next token.
+};
+
+/**
+ * @brief The values emitted by `rateLimit`: batches with `RateLimitPolicy::Batch`, single values otherwise.
+ */
+template <typename T, RateLimitPolicy Policy>
+using RateLimited = std::conditional_t<Policy == RateLimitPolicy::Batch, std::vector<T>, T>;
+
+namespace impl {
+
+template <typename T, RateLimitPolicy Policy>
+class RateLimitState;
+
+} // namespace impl
+
+/**
+ * @brief Counters of a `rateLimit` operator.
+ *
+ * Copies of a `RateLimitStats` share the same counters, so a copy passed to `rateLimit()`
+ * can be read from elsewhere. The counters are updated atomically and cover all
+ * subscriptions of the operator.
+ */
+class RateLimitStats {
+public:
+    RateLimitStats() : counters(std::make_shared<Counters>()) {}
+
+    /**
+     * @brief Returns the number of values that exceeded the rate and were emitted later.
+     */
+    std::uint64_t delayed() const {
+        return counters->delayed.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the number of values that exceeded the rate and were discarded.
+     */
+    std::uint64_t dropped() const {
+        return counters->dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Counters {
+        std::atomic<std::uint64_t> delayed = 0;
+        std::atomic<std::uint64_t> dropped = 0;
+    };
+
+    std::shared_ptr<Counters> counters;
+
+    template <typename T, RateLimitPolicy Policy>
+    friend class impl::RateLimitState;
+};
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// A token bucket in its "generic cell rate algorithm" form: instead of counting tokens, it
+// keeps the theoretical arrival time of the next conforming value in a single atomic, so
+// taking a token is one compare-and-swap and no refill timer is needed.
+class TokenBucket {
+public:
+    TokenBucket(double ratePerSecond, std::size_t burst)
+        : interval(std::max<std::int64_t>(1, std::llround(1e9 / ratePerSecond))),
+          tolerance(static_cast<std::int64_t>(burst - 1) * interval) {}
+
+    // Takes a token if one is available at `now`
+    bool tryAcquire(Scheduler::TimePoint now) {
+        std::int64_t time = nanoseconds(now);
+        std::int64_t arrival = theoreticalArrival.load(std::memory_order_relaxed);
+
+        do {
+            if (arrival - tolerance > time) {
+                return false;
+            }
+        } while (!theoreticalArrival.compare_exchange_weak(arrival, std::max(arrival, time) + interval, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        return true;
+    }
+
+    // The point in time at which the next token becomes available
+    Scheduler::TimePoint nextAvailable() const {
+        return Scheduler::TimePoint(std::chrono::nanoseconds(theoreticalArrival.load(std::memory_order_relaxed) - tolerance));
+    }
+
+private:
+    const std::int64_t interval;
+    const std::int64_t tolerance;
+    std::atomic<std::int64_t> theoreticalArrival = 0;
+
+    static std::int64_t nanoseconds(Scheduler::TimePoint time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+};
+
+template <typename T, RateLimitPolicy Policy>
+class RateLimitState {
+public:
+    using Output = RateLimited<T, Policy>;
+
+    RateLimitState(std::shared_ptr<const Subscriber<Output>> subscriber, double ratePerSecond, std::size_t burst, Scheduler scheduler, RateLimitStats stats)
+        : subscriber(std::move(subscriber)), bucket(ratePerSecond, burst), scheduler(std::move(scheduler)), stats(std::move(stats)) {}
+
+    static std::shared_ptr<RateLimitState> create(const Subscriber<Output>& subscriber, double ratePerSecond, std::size_t burst, Scheduler scheduler, RateLimitStats stats) {
+        auto state = std::make_shared<RateLimitState>(subscriber.shared_from_this(), ratePerSecond, burst, scheduler, std::move(stats));
+
+        state->timer = scheduler.createTimer([weakState = std::weak_ptr<RateLimitState>(state)]() {
+            if (auto state = weakState.lock()) {
+                state->drain();
+            }
+        });
+
+        return state;
+    }
+
+    void next(const T& t) {
+        // Fast path: nothing is waiting and a token is available
+        if (queued.load(std::memory_order_acquire) == 0 && bucket.tryAcquire(scheduler.now())) {
+            if constexpr (Policy == RateLimitPolicy::Batch) {
+                single.clear();
+                single.push_back(t);
+                subscriber->next(single);
+            } else {
+                subscriber->next(t);
+            }
+            return;
+        }
+
+        if constexpr (Policy == RateLimitPolicy::Drop) {
+            stats.counters->dropped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            std::unique_lock lock(mutex);
+            pending.push_back(t);
+            queued.fetch_add(1, std::memory_order_release);
+            stats.counters->delayed.fetch_add(1, std::memory_order_relaxed);
+
+            if (!draining && !timer.isPending()) {
+                timer.reschedule(bucket.nextAvailable());
+            }
+        }
+    }
+
+    void error(const std::exception_ptr& err) {
+        std::unique_lock lock(mutex);
+        timer.cancel();
+        pending.clear();
+        subscriber->error(err);
+    }
+
+    void complete() {
+        std::unique_lock lock(mutex);
+        if (queued.load(std::memory_order_acquire) == 0) {
+            subscriber->complete();
+        } else {
+            done = true;
+        }
+    }
+
+    void cancel() {
+        timer.cancel();
+    }
+
+private:
+    const std::shared_ptr<const Subscriber<Output>> subscriber;
+    TokenBucket bucket;
+    const Scheduler scheduler;
+    const RateLimitStats stats;
+    Timer timer;
+
+    // Values waiting for a token or being emitted by the drain; only the source adds to it
+    std::atomic<std::size_t> queued = 0;
+
+    std::mutex mutex;
+    std::deque<T> pending;
+    bool draining = false;
+    bool done = false;
+
+    // Batches handed to the subscriber
+    std::vector<T> single;
+    std::vector<T> batch;
+
+    void drain() {
+        std::unique_lock lock(mutex);
+        draining = true;
+
+        while (!pending.empty()) {
+            if (!bucket.tryAcquire(scheduler.now())) {
+                timer.reschedule(bucket.nextAvailable());
+                draining = false;
+                return;
+            }
+
+            std::size_t count = 1;
+            if constexpr (Policy == RateLimitPolicy::Batch) {
+                batch.assign(std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.end()));
+                count = batch.size();
+                pending.clear();
+
+                lock.unlock();
+                subscriber->next(batch);
+            } else {
+                T value = std::move(pending.front());
+                pending.pop_front();
+
+                lock.unlock();
+                subscriber->next(value);
+            }
+
+            queued.fetch_sub(count, std::memory_order_release);
+            lock.lock();
+        }
+
+        draining = false;
+        if (done) {
+            subscriber->complete();
+        }
+    }
+};
+
+} // namespace impl
+
+/**
+ * @brief Limits the rate of an observable with a token bucket.
+ *
+ * Tokens accrue at `ratePerSecond`, up to `burst` tokens, and each emission takes one.
+ * While tokens are available, values pass straight through: taking a token is a single
+ * compare-and-swap, without locking. Values that exceed the rate are handled by `Policy`:
+ * - `Delay` queues them and emits them in order as tokens become available.
+ * - `Drop` discards them.
+ * - `Batch` collects them and emits everything collected as one `std::vector<T>` for the
+ *   next token, which suits quotas on operations rather than on values, e.g. writes to a
+ *   store. With this policy every emission is a vector, valid only during `next`.
+ *
+ * Waiting for tokens uses a single timer of `scheduler` that is rescheduled as needed, so
+ * the operator works on any scheduler, including virtual time.
+ *
+ * The resulting observable:
+ * - Emits values no faster than the rate, after an initial burst of up to `burst` values.
+ * - Completes when the source completes, once the delayed values were emitted.
+ * - Forwards errors from the source right away, discarding delayed values.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @tparam Policy What to do with values that exceed the rate.
+ * @param ratePerSecond The sustained number of emissions per second.
+ * @param burst The number of emissions allowed at once after a quiet period.
+ * @param scheduler The scheduler whose clock and timers measure the rate.
+ * @param stats The counters of delayed and dropped values.
+ * @return Operator<T, RateLimited<T, Policy>> A function that rate-limits an observable.
+ * @throws std::invalid_argument If the rate is not positive or the burst is zero.
+ */
+template <typename T, RateLimitPolicy Policy = RateLimitPolicy::Delay>
+Operator<T, RateLimited<T, Policy>> rateLimit(double ratePerSecond, std::size_t burst, Scheduler scheduler, RateLimitStats stats = RateLimitStats()) {
+    if (!(ratePerSecond > 0) || burst == 0) {
+        throw std::invalid_argument("rateLimit: rate and burst must be positive");
+    }
+
+    using Output = RateLimited<T, Policy>;
+
+    return [ratePerSecond, burst, scheduler, stats](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<Output>([ratePerSecond, burst, scheduler, stats, sourceObservable](const Subscriber<Output>& subscriber) {
+            auto state = impl::RateLimitState<T, Policy>::create(subscriber, ratePerSecond, burst, scheduler, stats);
+
+            Observer<T> intermediateObserver(
+                [state](const T& t) { state->next(t); },
+                [state](const std::exception_ptr& err) { state->error(err); },
+                [state]() { state->complete(); }
+            );
+
+            return [state, subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+                state->cancel();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// Folds values into a per-subscription accumulator that `step` updates in place.
+//
+// With `EmitsEach`, the accumulator is emitted by reference after every value, otherwise once
+// when the source completes. Either way it is never copied after the subscription starts.
+template <typename T, typename Acc, bool EmitsEach, typename Step>
+Operator<T, Acc> fold(Acc seed, Step step) {
+    return [seed = std::move(seed), step = std::move(step)](const Observable<T>& sourceObservable) {
+        return ObservableFactory<Acc>([seed, step, sourceObservable](const Subscriber<Acc>& subscriber) {
+            auto accumulator = std::make_shared<Acc>(seed);
+
+            Observer<T> intermediateObserver(
+                [step, accumulator, subscriber = subscriber.shared_from_this()](const T& t) {
+                    std::invoke(step, *accumulator, t);
+                    if constexpr (EmitsEach) {
+                        subscriber->next(*accumulator);
+                    }
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    subscriber->error(err);
+                },
+                [accumulator, subscriber = subscriber.shared_from_this()]() {
+                    if constexpr (!EmitsEach) {
+                        subscriber->next(*accumulator);
+                    }
+                    subscriber->complete();
+                }
+            );
+
+            return [subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+            };
+        });
+    };
+}
+
+// Adapts an accumulator function returning the next accumulator to an in-place step
+template <typename Func>
+auto replacingStep(Func accumulatorFunc) {
+    return [accumulatorFunc = std::move(accumulatorFunc)]<typename Acc, typename T>(Acc& accumulator, const T& t) {
+        // Moved in, so accumulators that reuse their argument do not copy it
+        accumulator = std::invoke(accumulatorFunc, std::move(accumulator), t);
+    };
+}
+
+// Adapts a function folding a span of values to an in-place step over whole batches
+template <typename Func>
+auto batchStep(Func foldFunc) {
+    return [foldFunc = std::move(foldFunc)]<typename Acc, typename Batch>(Acc& accumulator, const Batch& batch) {
+        std::invoke(foldFunc, accumulator, std::span<const std::ranges::range_value_t<Batch>>(batch));
+    };
+}
+
+} // namespace impl
+
+/**
+ * @brief Folds the values of an observable and emits the result once it completes.
+ *
+ * Starting from `seed`, each value is combined with the accumulator by `accumulatorFunc`,
+ * which returns the next accumulator; it receives the current one as an rvalue, so it can
+ * modify and return it without a copy. Each subscription folds from its own copy of `seed`.
+ *
+ * The resulting observable:
+ * - Emits the final accumulator when the source completes, or `seed` if it emitted nothing.
+ * - Completes right after.
+ * - Forwards errors from the source.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param seed The initial accumulator.
+ * @param accumulatorFunc A callable taking an `Acc&&` and a `const T&` and returning an `Acc`.
+ * @return Operator<T, Acc> A function that reduces an observable.
+ */
+template <typename T, typename Acc, typename Func>
+    requires std::is_invocable_r_v<Acc, Func&, Acc&&, const T&>
+Operator<T, Acc> reduce(Acc seed, Func&& accumulatorFunc) {
+    return impl::fold<T, Acc, false>(std::move(seed), impl::replacingStep(std::forward<Func>(accumulatorFunc)));
+}
+
+/**
+ * @brief Folds whole batches of values and emits the result once the source completes.
+ *
+ * Like `reduceInPlace`, for sources emitting batches, such as those of `bufferCount` or
+ * `adaptiveBatch`. `foldFunc` receives each batch as a `std::span`, so it can fold all its
+ * values in one tight loop instead of being called once per value.
+ *
+ * @tparam Batch The type of batches emitted by the source observable, a contiguous range.
+ * @param seed The initial accumulator.
+ * @param foldFunc A callable taking an `Acc&` and a `std::span<const V>` of a batch's values.
+ * @return Operator<Batch, Acc> A function that reduces an observable of batches.
+ */
+template <typename Batch, typename Acc, typename Func>
+    requires std::ranges::contiguous_range<const Batch&> &&
+             std::is_invocable_v<Func&, Acc&, std::span<const std::ranges::range_value_t<Batch>>>
+Operator<Batch, Acc> reduceBatches(Acc seed, Func&& foldFunc) {
+    return impl::fold<Batch, Acc, false>(std::move(seed), impl::batchStep(std::forward<Func>(foldFunc)));
+}
+
+/**
+ * @brief Folds the values of an observable into a mutable accumulator, emitting the result on completion.
+ *
+ * `stepFunc` updates the accumulator in place, which suits accumulators that are expensive
+ * to copy or move, such as histograms or maps.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param seed The initial accumulator.
+ * @param stepFunc A callable taking an `Acc&` and a `const T&` that updates the accumulator.
+ * @return Operator<T, Acc> A function that reduces an observable.
+ */
+template <typename T, typename Acc, typename Func>
+    requires std::is_invocable_v<Func&, Acc&, const T&>
+Operator<T, Acc> reduceInPlace(Acc seed, Func&& stepFunc) {
+    return impl::fold<T, Acc, false>(std::move(seed), std::forward<Func>(stepFunc));
+}
+
+/**
+ * @brief Emits the latest value at periodic intervals.
+ *
+ * Every `period`, the latest value received since the previous sample is emitted; periods
+ * without new values emit nothing. The sampling timer starts on subscription and is
+ * rescheduled rather than recreated for each period.
+ *
+ * The resulting observable:
+ * - Emits the latest new value at the end of each period.
+ * - Completes when the source completes, without emitting the unsampled value.
+ * - Forwards errors from the source.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param period The sampling interval.
+ * @param scheduler The scheduler whose timer triggers the samples.
+ * @return Operator<T, T> A function that samples an observable.
+ */
+template <typename T>
+Operator<T, T> sampleTime(Scheduler::Duration period, Scheduler scheduler) {
+    return [period, scheduler](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<T>([period, scheduler, sourceObservable](const Subscriber<T>& subscriber) {
+            using Limiter = impl::RateLimiter<T>;
+
+            auto limiter = Limiter::create(subscriber, scheduler, [period](Limiter& limiter) {
+                limiter.emitPending();
+                limiter.timer.rescheduleAfter(period);
+            });
+            limiter->timer.rescheduleAfter(period);
+
+            return Limiter::subscribe(limiter, sourceObservable,
+                [](Limiter& limiter, const T& t) { limiter.pending = t; },
+                [](Limiter& limiter) { limiter.pending.reset(); }
+            );
+        });
+    };
+}
+
+/**
+ * @brief Folds the values of an observable and emits every intermediate accumulator.
+ *
+ * Like `reduce`, but the accumulator is emitted after each value. Each subscription folds
+ * from its own copy of `seed`.
+ *
+ * The resulting observable:
+ * - Emits the accumulator after each value from the source.
+ * - Completes when the source completes.
+ * - Forwards errors from the source.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param seed The initial accumulator, which is not emitted itself.
+ * @param accumulatorFunc A callable taking an `Acc&&` and a `const T&` and returning an `Acc`.
+ * @return Operator<T, Acc> A function that accumulates an observable.
+ */
+template <typename T, typename Acc, typename Func>
+    requires std::is_invocable_r_v<Acc, Func&, Acc&&, const T&>
+Operator<T, Acc> scan(Acc seed, Func&& accumulatorFunc) {
+    return impl::fold<T, Acc, true>(std::move(seed), impl::replacingStep(std::forward<Func>(accumulatorFunc)));
+}
+
+/**
+ * @brief Folds whole batches of values, emitting the accumulator after each batch.
+ *
+ * Like `reduceBatches`, but the accumulator is emitted after each batch.
+ *
+ * @tparam Batch The type of batches emitted by the source observable, a contiguous range.
+ * @param seed The initial accumulator, which is not emitted itself.
+ * @param foldFunc A callable taking an `Acc&` and a `std::span<const V>` of a batch's values.
+ * @return Operator<Batch, Acc> A function that accumulates an observable of batches.
+ */
+template <typename Batch, typename Acc, typename Func>
+    requires std::ranges::contiguous_range<const Batch&> &&
+             std::is_invocable_v<Func&, Acc&, std::span<const std::ranges::range_value_t<Batch>>>
+Operator<Batch, Acc> scanBatches(Acc seed, Func&& foldFunc) {
+    return impl::fold<Batch, Acc, true>(std::move(seed), impl::batchStep(std::forward<Func>(foldFunc)));
+}
+
+/**
+ * @brief Folds the values of an observable into a mutable accumulator, emitting it after each value.
+ *
+ * `stepFunc` updates the accumulator in place, and subscribers receive a const reference
+ * to it, so aggregating into a histogram or a map copies nothing per value. Subscribers
+ * that keep the accumulator must copy it, as it changes with the next value.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param seed The initial accumulator, which is not emitted itself.
+ * @param stepFunc A callable taking an `Acc&` and a `const T&` that updates the accumulator.
+ * @return Operator<T, Acc> A function that accumulates an observable.
+ */
+template <typename T, typename Acc, typename Func>
+    requires std::is_invocable_v<Func&, Acc&, const T&>
+Operator<T, Acc> scanInPlace(Acc seed, Func&& stepFunc) {
+    return impl::fold<T, Acc, true>(std::move(seed), std::forward<Func>(stepFunc));
+}
+
+namespace impl {
+
+template <typename T>
+class ShedLoadState;
+
+} // namespace impl
+
+/**
+ * @brief Counters of a `shedLoad` operator.
+ *
+ * Copies of a `ShedStats` share the same counters, so a copy passed to `shedLoad()` can be
+ * read from elsewhere. The counters cover all subscriptions of the operator.
+ */
+class ShedStats {
+public:
+    ShedStats() : counters(std::make_shared<Counters>()) {}
+
+    /**
+     * @brief Returns the number of values of the given priority that were shed.
+     */
+    std::uint64_t shed(int priority) const {
+        std::unique_lock lock(counters->mutex);
+        auto it = counters->byPriority.find(priority);
+        return it == counters->byPriority.end() ? 0 : it->second;
+    }
+
+    /**
+     * @brief Returns the number of values that were shed, over all priorities.
+     */
+    std::uint64_t total() const {
+        return counters->total.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the number of values shed per priority, for the priorities that lost any.
+     */
+    std::map<int, std::uint64_t> byPriority() const {
+        std::unique_lock lock(counters->mutex);
+        return counters->byPriority;
+    }
+
+private:
+    struct Counters {
+        std::atomic<std::uint64_t> total = 0;
+        mutable std::mutex mutex;
+        std::map<int, std::uint64_t> byPriority;
+    };
+
+    std::shared_ptr<Counters> counters;
+
+    void record(int priority) const {
+        counters->total.fetch_add(1, std::memory_order_relaxed);
+
+        std::unique_lock lock(counters->mutex);
+        counters->byPriority[priority]++;
+    }
+
+    template <typename T>
+    friend class impl::ShedLoadState;
+};
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
  */
-template <typename T, typename Func, typename U = std::invoke_result_t<Func, const T&>>
-Operator<T, U> map(Func&& mapFunc) {
-    return [mapFunc = std::forward<Func>(mapFunc)](const Observable<T>& sourceObservable) {
-        return impl::ObservableFactory<U>([mapFunc, sourceObservable](const Subscriber<U>& subscriber) {
+namespace impl {
+
+// The queue between the producer and the consumer of `shedLoad`. Pending values are kept
+// in one FIFO per priority, ordered by priority, so both the next value to emit (the oldest
+// of the highest priority) and the next value to shed (the oldest of the lowest priority)
+// are found without scanning the queue. The FIFOs of priorities that ran empty are kept, as
+// the few priorities of a stream keep coming back.
+template <typename T>
+class ShedLoadState {
+public:
+    ShedLoadState(std::shared_ptr<const Subscriber<T>> subscriber, std::size_t budget, ShedStats stats)
+        : subscriber(std::move(subscriber)), budget(budget), stats(std::move(stats)) {}
+
+    static std::shared_ptr<ShedLoadState> create(const Subscriber<T>& subscriber, std::size_t budget, const Scheduler& scheduler, ShedStats stats) {
+        auto state = std::make_shared<ShedLoadState>(subscriber.shared_from_this(), budget, std::move(stats));
+
+        state->timer = scheduler.createTimer([weakState = std::weak_ptr<ShedLoadState>(state)]() {
+            if (auto state = weakState.lock()) {
+                state->drain();
+            }
+        });
+
+        return state;
+    }
+
+    void next(const T& t, int priority) {
+        std::unique_lock lock(mutex);
+        if (terminated) {
+            return;
+        }
+
+        if (size == budget) {
+            auto lowest = lowestPending();
+
+            // The new value is the least important one, so it is the one to go
+            if (priority < lowest->first) {
+                stats.record(priority);
+                return;
+            }
+
+            lowest->second.pop_front();
+            size--;
+            stats.record(lowest->first);
+        }
+
+        pending[priority].push_back(t);
+        size++;
+        scheduleDrain();
+    }
+
+    // Terminal events are only recorded here; the drain delivers them, so the subscriber is
+    // never called from two threads at once
+    void error(const std::exception_ptr& err) {
+        std::unique_lock lock(mutex);
+        if (terminated) {
+            return;
+        }
+
+        terminated = true;
+        terminalError = err;
+        clear();
+        scheduleDrain();
+    }
+
+    void complete() {
+        std::unique_lock lock(mutex);
+        if (terminated) {
+            return;
+        }
+
+        terminated = true;
+        completed = true;
+        scheduleDrain();
+    }
+
+    void cancel() {
+        timer.cancel();
+
+        std::unique_lock lock(mutex);
+        clear();
+    }
+
+private:
+    const std::shared_ptr<const Subscriber<T>> subscriber;
+    const std::size_t budget;
+    const ShedStats stats;
+    Timer timer;
+
+    std::mutex mutex;
+    std::map<int, std::deque<T>> pending;
+    std::size_t size = 0;
+    bool scheduled = false;
+    bool terminated = false;
+    bool completed = false;
+    std::exception_ptr terminalError;
+
+    // Must be called with the mutex held and values pending
+    typename std::map<int, std::deque<T>>::iterator lowestPending() {
+        auto it = pending.begin();
+        while (it->second.empty()) {
+            ++it;
+        }
+        return it;
+    }
+
+    typename std::map<int, std::deque<T>>::reverse_iterator highestPending() {
+        auto it = pending.rbegin();
+        while (it->second.empty()) {
+            ++it;
+        }
+        return it;
+    }
+
+    // Must be called with the mutex held
+    void scheduleDrain() {
+        if (!scheduled) {
+            scheduled = true;
+            timer.rescheduleAfter(Scheduler::Duration::zero());
+        }
+    }
+
+    void clear() {
+        for (auto& [priority, values] : pending) {
+            values.clear();
+        }
+        size = 0;
+    }
+
+    void drain() {
+        std::unique_lock lock(mutex);
+
+        while (size > 0 && !terminalError) {
+            auto highest = highestPending();
+            T value = std::move(highest->second.front());
+            highest->second.pop_front();
+            size--;
+
+            // Producers keep queueing, and shedding, while the subscriber handles the value
+            lock.unlock();
+            subscriber->next(value);
+            lock.lock();
+        }
+
+        scheduled = false;
+
+        // Pending values were cleared by an error, so the queue is empty either way
+        std::exception_ptr err = std::exchange(terminalError, nullptr);
+        bool finished = std::exchange(completed, false);
+        lock.unlock();
+
+        if (err) {
+            subscriber->error(err);
+        } else if (finished) {
+            subscriber->complete();
+        }
+    }
+};
+
+} // namespace impl
+
+/**
+ * @brief Hands values to a consumer on a scheduler, shedding the least important ones under overload.
+ *
+ * The `shedLoad` operator decouples the producer from the consumer like `observeOn`, but
+ * bounds the values in between to `queueBudget`. Each value is assigned an integer priority
+ * by `priorityFn`. When the budget is exhausted, the producer is never blocked; instead the
+ * oldest pending value of the lowest priority is shed, or the new value itself if its
+ * priority is lower still. Pending values are emitted highest priority first, and in order
+ * within a priority, so for example control messages overtake a flood of data messages
+ * rather than being lost in it.
+ *
+ * The number of shed values per priority is counted in `stats`.
+ *
+ * The resulting observable:
+ * - Emits the pending values on `scheduler`, highest priority first.
+ * - Completes once the pending values were emitted after the source completes.
+ * - Forwards errors from the source on `scheduler`, after the value being emitted, discarding pending values.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param priorityFn A function returning the priority of a value; higher is more important.
+ * @param queueBudget The maximum number of pending values.
+ * @param scheduler The scheduler on which values are emitted.
+ * @param stats The counters of shed values.
+ * @return Operator<T, T> A function that applies load shedding to an observable.
+ * @throws std::invalid_argument If `queueBudget` is zero.
+ */
+template <typename T, typename Func>
+Operator<T, T> shedLoad(Func&& priorityFn, std::size_t queueBudget, Scheduler scheduler, ShedStats stats = ShedStats()) {
+    if (queueBudget == 0) {
+        throw std::invalid_argument("shedLoad: queueBudget must be positive");
+    }
+
+    return [priorityFn = std::forward<Func>(priorityFn), queueBudget, scheduler, stats](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<T>([priorityFn, queueBudget, scheduler, stats, sourceObservable](const Subscriber<T>& subscriber) {
+            auto state = impl::ShedLoadState<T>::create(subscriber, queueBudget, scheduler, stats);
+
             Observer<T> intermediateObserver(
-                [mapFunc, subscriber = subscriber.shared_from_this()](const T& t) {
-                    subscriber->next(std::invoke(mapFunc, t));
+                [state, priorityFn](const T& t) { state->next(t, static_cast<int>(priorityFn(t))); },
+                [state](const std::exception_ptr& err) { state->error(err); },
+                [state]() { state->complete(); }
+            );
+
+            return [state, subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
+                subscription.unsubscribe();
+                state->cancel();
+            };
+        });
+    };
+}
+
+/**
+ * @brief Configures which values of a period `throttleTime` emits.
+ */
+struct ThrottleConfig {
+    /**
+     * @brief Emit the value that starts a period.
+     */
+    bool leading = true;
+
+    /**
+     * @brief Emit the latest value of a period when it ends.
+     */
+    bool trailing = false;
+};
+
+/**
+ * @brief Maps each value to an observable, switching to the newest observable.
+ *
+ * The `switchMap` operator subscribes to the observable returned by `project` for each value
+ * and unsubscribes from the observable of the previous value, so only the values of the
+ * latest inner observable are emitted. This suits lookups that are superseded by newer
+ * input, such as search suggestions.
+ *
+ * The resulting observable:
+ * - Emits the values of the latest inner observable.
+ * - Completes when the source and the latest inner observable have completed.
+ * - Forwards errors from the source and the latest inner observable.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param project A function returning the observable for a value.
+ * @return Operator<T, U> A function that applies the mapping and flattening to an observable.
+ */
+template <typename T, typename Func, typename U = impl::FlattenedValue<std::decay_t<Func>, T>>
+Operator<T, U> switchMap(Func&& project) {
+    return impl::flatten<T, impl::FlattenStrategy::Switch>(std::forward<Func>(project), 1);
+}
+
+/**
+ * @brief Emits at most one value per period of time.
+ *
+ * A value that arrives while no period is running starts one of length `duration`. With
+ * `leading` enabled that value is emitted right away; with `trailing` enabled the latest
+ * value received during the period is emitted when it ends, which starts the next period.
+ * Values arriving in a running period are otherwise dropped. The same timer is rescheduled
+ * for every period.
+ *
+ * The resulting observable:
+ * - Emits the first and/or last value of each period, depending on `config`.
+ * - Emits the pending trailing value and completes when the source completes.
+ * - Forwards errors from the source, dropping the pending value.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param duration The length of each period.
+ * @param scheduler The scheduler whose timers measure the periods.
+ * @param config Whether to emit the leading and/or the trailing value of a period.
+ * @return Operator<T, T> A function that applies the throttling to an observable.
+ */
+template <typename T>
+Operator<T, T> throttleTime(Scheduler::Duration duration, Scheduler scheduler, ThrottleConfig config = ThrottleConfig()) {
+    return [duration, scheduler, config](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<T>([duration, scheduler, config, sourceObservable](const Subscriber<T>& subscriber) {
+            using Limiter = impl::RateLimiter<T>;
+
+            auto limiter = Limiter::create(subscriber, scheduler, [duration](Limiter& limiter) {
+                // A trailing value starts the next period
+                if (limiter.emitPending()) {
+                    limiter.timer.rescheduleAfter(duration);
+                }
+            });
+
+            return Limiter::subscribe(limiter, sourceObservable,
+                [duration, config](Limiter& limiter, const T& t) {
+                    if (limiter.timer.isPending()) {
+                        if (config.trailing) {
+                            limiter.pending = t;
+                        }
+                        return;
+                    }
+
+                    limiter.timer.rescheduleAfter(duration);
+                    if (config.leading) {
+                        limiter.subscriber->next(t);
+                    } else if (config.trailing) {
+                        limiter.pending = t;
+                    }
                 },
-                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { 
-                    subscriber->error(err); 
+                [](Limiter& limiter) { limiter.emitPending(); }
+            );
+        });
+    };
+}
+
+/**
+ * @brief Splits the values of an observable into windows of a fixed size.
+ *
+ * The `windowCount` operator works like `bufferCount`, but emits each window as an
+ * observable as soon as it opens, and forwards values to it as they arrive. Windows can
+ * thus be aggregated in a streaming fashion, in constant memory. A new window opens every
+ * `skip` values and completes once it received `count` values.
+ *
+ * Windows are lightweight subjects that are reused for later windows once they completed
+ * and no copy of their observable is left. Subscribe to a window when it is emitted;
+ * subscribing after it completed only yields the completion.
+ *
+ * The resulting observable:
+ * - Emits a window every `skip` values, starting with the first value.
+ * - Completes the open windows, and then itself, when the source completes.
+ * - Forwards errors from the source to the open windows and to its subscriber.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param count The number of values in a window.
+ * @param skip The number of values after which a new window is opened; defaults to `count`.
+ * @return Operator<T, Observable<T>> A function that splits an observable into windows.
+ * @throws std::invalid_argument If `count` is zero.
+ */
+template <typename T>
+Operator<T, Observable<T>> windowCount(std::size_t count, std::size_t skip = 0) {
+    skip = skip == 0 ? count : skip;
+    if (count == 0) {
+        throw std::invalid_argument("windowCount: count must be positive");
+    }
+
+    return [count, skip](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<Observable<T>>([count, skip, sourceObservable](const Subscriber<Observable<T>>& subscriber) {
+            struct State {
+                impl::WindowPool<T> pool;
+                std::vector<std::shared_ptr<impl::WindowSubject<T>>> open;
+                std::size_t index = 0;
+            };
+
+            auto state = std::make_shared<State>();
+            state->open.reserve((count + skip - 1) / skip);
+
+            auto closeAll = [state](const std::exception_ptr& err) {
+                for (const auto& window : state->open) {
+                    if (err) {
+                        window->error(err);
+                    } else {
+                        window->complete();
+                    }
+                }
+
+                state->open.clear();
+            };
+
+            Observer<T> intermediateObserver(
+                [count, skip, state, subscriber = subscriber.shared_from_this()](const T& t) {
+                    if (state->index++ % skip == 0) {
+                        state->open.push_back(state->pool.acquire());
+                        subscriber->next(state->open.back()->observable());
+                    }
+
+                    for (const auto& window : state->open) {
+                        window->next(t);
+                        window->count++;
+                    }
+
+                    if (!state->open.empty() && state->open.front()->count == count) {
+                        std::shared_ptr<impl::WindowSubject<T>> window = std::move(state->open.front());
+                        state->open.erase(state->open.begin());
+
+                        window->complete();
+                        state->pool.release(std::move(window));
+                    }
                 },
-                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
+                [closeAll, subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                    closeAll(err);
+                    subscriber->error(err);
+                },
+                [closeAll, subscriber = subscriber.shared_from_this()]() {
+                    closeAll(nullptr);
+                    subscriber->complete();
+                }
             );
 
             return [subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
@@ -233,53 +3348,334 @@ Operator<T, U> map(Func&& mapFunc) {
 }
 
 /**
- * @brief Merges multiple observables of the same value type into a single observable stream.
- * 
- * The `merge` function takes multiple observables that emit values of type `T` and 
- * combines them into a single observable. All values emitted by the source observable 
- * and the additional input observables will be forwarded to the same downstream subscriber.
- * 
- * Completion occurs when all upstream observables complete. Errors are forwarded immediately.
- * 
- * @tparam T The common value type emitted by all observables.
- * @tparam Ts Variadic list of types, all of which must be `T`.
- * @param observables One or more observables that emit values of type `T`.
- * @return Operator<T, T> A function that, when applied to an observable, produces a merged observable stream.
+ * @brief Splits the values of an observable into windows of time, optionally sliding.
+ *
+ * The `windowTime` operator opens a window right away and then every `timeShift`, and
+ * closes each window `timespan` after it opened. Each window is emitted as an observable
+ * when it opens and receives the values that arrive while it is open. With `timeShift`
+ * equal to `timespan` (the default) the windows are consecutive; with a smaller
+ * `timeShift` they overlap, i.e. slide, and with a larger one values in between are dropped.
+ *
+ * Windows are lightweight subjects that are reused for later windows once they completed
+ * and no copy of their observable is left. Every window keeps its own closing timer across
+ * reuses, so that after warming up, opening and closing windows does not allocate.
+ *
+ * The resulting observable:
+ * - Emits a window when it opens.
+ * - Completes the open windows, and then itself, when the source completes.
+ * - Forwards errors from the source to the open windows and to its subscriber.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param timespan How long each window stays open.
+ * @param scheduler The scheduler whose clock measures the windows.
+ * @param timeShift The interval at which windows open; defaults to `timespan`.
+ * @return Operator<T, Observable<T>> A function that splits an observable into windows.
  */
-template <typename T, typename... Ts>
-requires(std::is_same_v<T, Ts> && ...)
-Operator<T, T> merge(const Observable<Ts>&... observables) {
-    return [observables...](const Observable<T>& sourceObservable) {
-        return impl::ObservableFactory<T>([sourceObservable, observables...](const Subscriber<T>& subscriber) {
-            const std::size_t totalSources = sizeof...(Ts) + 1;
-            auto completedCounter = std::make_shared<size_t>(0);
+template <typename T>
+Operator<T, Observable<T>> windowTime(Scheduler::Duration timespan, Scheduler scheduler, Scheduler::Duration timeShift = Scheduler::Duration::zero()) {
+    timeShift = timeShift == Scheduler::Duration::zero() ? timespan : timeShift;
+
+    return [timespan, scheduler, timeShift](const Observable<T>& sourceObservable) {
+        return impl::ObservableFactory<Observable<T>>([timespan, scheduler, timeShift, sourceObservable](const Subscriber<Observable<T>>& subscriber) {
+            using Window = impl::WindowSubject<T>;
+
+            struct State : std::enable_shared_from_this<State> {
+                const std::shared_ptr<const Subscriber<Observable<T>>> subscriber;
+                const Scheduler scheduler;
+                const Scheduler::Duration timespan;
+                Timer openTimer;
+
+                // Recursive, as consumers may feed the source from `next`
+                std::recursive_mutex mutex;
+                impl::WindowPool<T> pool;
+                std::vector<std::shared_ptr<Window>> open;
+                bool done = false;
+
+                State(std::shared_ptr<const Subscriber<Observable<T>>> subscriber, Scheduler scheduler, Scheduler::Duration timespan)
+                    : subscriber(std::move(subscriber)), scheduler(std::move(scheduler)), timespan(timespan) {}
+
+                // Must be called with the mutex held
+                void openWindow() {
+                    // Windows closing now go first, whichever timer fires first
+                    Scheduler::TimePoint now = scheduler.now();
+                    for (std::size_t i = 0; i < open.size();) {
+                        if (open[i]->closesAt <= now) {
+                            closeWindow(open[i].get());
+                        } else {
+                            i++;
+                        }
+                    }
+
+                    std::shared_ptr<Window> window = pool.acquire();
+                    if (!window->closeTimer) {
+                        window->closeTimer = scheduler.createTimer([weakState = this->weak_from_this(), target = window.get()]() {
+                            if (auto state = weakState.lock()) {
+                                std::unique_lock lock(state->mutex);
+                                state->closeWindow(target);
+                            }
+                        });
+                    }
+
+                    window->closesAt = now + timespan;
+                    window->closeTimer->reschedule(window->closesAt);
+                    open.push_back(window);
+                    subscriber->next(window->observable());
+                }
+
+                // Must be called with the mutex held
+                void closeWindow(Window* target) {
+                    auto position = std::find_if(open.begin(), open.end(), [target](const auto& window) { return window.get() == target; });
+                    if (position == open.end()) {
+                        return;
+                    }
+
+                    std::shared_ptr<Window> window = std::move(*position);
+                    open.erase(position);
+
+                    window->closeTimer->cancel();
+                    window->complete();
+                    pool.release(std::move(window));
+                }
+
+                // Must be called with the mutex held
+                void closeAll(const std::exception_ptr& err) {
+                    done = true;
+                    openTimer.cancel();
+
+                    for (const auto& window : open) {
+                        window->closeTimer->cancel();
+                        if (err) {
+                            window->error(err);
+                        } else {
+                            window->complete();
+                        }
+                    }
+
+                    open.clear();
+                }
+            };
+
+            auto state = std::make_shared<State>(subscriber.shared_from_this(), scheduler, timespan);
+            std::weak_ptr<State> weakState = state;
+
+            state->openTimer = scheduler.createTimer([weakState, timeShift]() {
+                if (auto state = weakState.lock()) {
+                    std::unique_lock lock(state->mutex);
+                    if (!state->done) {
+                        state->openWindow();
+                        state->openTimer.rescheduleAfter(timeShift);
+                    }
+                }
+            });
+
+            {
+                std::unique_lock lock(state->mutex);
+                state->openWindow();
+                state->openTimer.rescheduleAfter(timeShift);
+            }
 
             Observer<T> intermediateObserver(
-                [subscriber = subscriber.shared_from_this()](const T& t) {
-                    subscriber->next(t);
+                [state](const T& t) {
+                    std::unique_lock lock(state->mutex);
+                    for (std::size_t i = 0; i < state->open.size(); i++) {
+                        state->open[i]->next(t);
+                    }
                 },
-                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { 
-                    subscriber->error(err); 
+                [state](const std::exception_ptr& err) {
+                    std::unique_lock lock(state->mutex);
+                    state->closeAll(err);
+                    state->subscriber->error(err);
                 },
-                [subscriber = subscriber.shared_from_this(), completedCounter, totalSources]() {
-                    *completedCounter += 1;
-
-                    if (*completedCounter == totalSources) {
-                        subscriber->complete();
-                    }
+                [state]() {
+                    std::unique_lock lock(state->mutex);
+                    state->closeAll(nullptr);
+                    state->subscriber->complete();
                 }
             );
 
-            Subscription subscription = sourceObservable.subscribe(intermediateObserver);
-            (subscription.add(observables.subscribe(intermediateObserver)), ...);
-
-            return [subscription]() mutable {
+            return [state, subscription = sourceObservable.subscribe(intermediateObserver)]() mutable {
                 subscription.unsubscribe();
+
+                std::unique_lock lock(state->mutex);
+                state->done = true;
+                state->openTimer.cancel();
+                for (const auto& window : state->open) {
+                    window->closeTimer->cancel();
+                }
+            };
+        });
+    };
+}
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+// The latest values of `withLatestFrom`, with a count of the values still missing, so
+// checking whether all are present does not look at each of them
+template <typename... Us>
+class LatestValues {
+public:
+    template <std::size_t I, typename U>
+    void store(const U& value) {
+        auto& slot = std::get<I>(values);
+        if (slot) {
+            *slot = value;
+        } else {
+            slot.emplace(value);
+            missing--;
+        }
+    }
+
+    bool ready() const {
+        return missing == 0;
+    }
+
+    // Calls `func` with references to the values; they must all be present
+    template <typename Func>
+    decltype(auto) apply(Func&& func) const {
+        return std::apply([&func](const auto&... slots) -> decltype(auto) { return func(*slots...); }, values);
+    }
+
+private:
+    std::tuple<std::optional<Us>...> values;
+    std::size_t missing = sizeof...(Us);
+};
+
+// A slot for a value written by one thread and read by others without locking.
+//
+// The writer makes the sequence number odd while it copies the value in and even again
+// afterwards; a reader copies the value out and retries if the sequence number was odd or
+// changed meanwhile. The value is kept in atomic words, so torn reads are discarded rather
+// than being data races. Words are stored with release and loaded with acquire semantics:
+// a reader that sees any word of a new value thereby sees the odd sequence number before
+// it, which needs no fences and compiles to plain moves on x86. Each slot sits on its own
+// cache line, as each has its own writer.
+template <typename U>
+requires std::is_trivially_copyable_v<U>
+class alignas(CacheLineSize) SeqlockSlot {
+public:
+    // Only one thread may store at a time, as is the case for the values of an observable
+    void store(const U& value) {
+        std::array<std::uint64_t, Words> words{};
+        std::memcpy(words.data(), &value, sizeof(U));
+
+        std::uint64_t before = sequence.load(std::memory_order_relaxed);
+        sequence.store(before + 1, std::memory_order_relaxed);
+
+        for (std::size_t i = 0; i < Words; i++) {
+            data[i].store(words[i], std::memory_order_release);
+        }
+
+        sequence.store(before + 2, std::memory_order_release);
+    }
+
+    U load() const {
+        std::array<std::uint64_t, Words> words;
+
+        for (;;) {
+            std::uint64_t before = sequence.load(std::memory_order_acquire);
+            if (before % 2 != 0) {
+                continue;
+            }
+
+            for (std::size_t i = 0; i < Words; i++) {
+                words[i] = data[i].load(std::memory_order_acquire);
+            }
+
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+
+        std::array<std::byte, sizeof(U)> bytes;
+        std::memcpy(bytes.data(), words.data(), sizeof(U));
+        return std::bit_cast<U>(bytes);
+    }
+
+private:
+    static constexpr std::size_t Words = (sizeof(U) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> sequence = 0;
+    std::array<std::atomic<std::uint64_t>, Words> data{};
+};
+
+// The latest values of the concurrent `withLatestFrom`, each in a seqlocked slot. A value
+// is counted as present only after it was stored, so a reader that sees none missing can
+// load all of them.
+template <typename... Us>
+class ConcurrentLatestValues {
+public:
+    template <std::size_t I, typename U>
+    void store(const U& value) {
+        std::get<I>(slots).store(value);
+
+        // Only the writer of a slot reads or writes its flag
+        if (!std::get<I>(present)) {
+            std::get<I>(present) = true;
+            missing.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    bool ready() const {
+        return missing.load(std::memory_order_acquire) == 0;
+    }
+
+    template <typename Func>
+    decltype(auto) apply(Func&& func) const {
+        return std::apply([&func](const auto&... slots) -> decltype(auto) { return func(slots.load()...); }, slots);
+    }
+
+private:
+    std::tuple<SeqlockSlot<Us>...> slots;
+    std::array<bool, sizeof...(Us)> present{};
+    std::atomic<std::size_t> missing = sizeof...(Us);
+};
+
+// Subscribes to the latest observables, storing their values in `Latest`, and calls
+// `emit(subscriber, value, latest)` for each value of the source once all are present
+template <typename Output, typename Latest, typename T, typename Emit, typename... Us>
+Operator<T, Output> withLatestFrom(Emit emit, Observable<Us>... latestObservables) {
+    return [emit, latestObservables...](const Observable<T>& sourceObservable) {
+        return ObservableFactory<Output>([emit, sourceObservable, latestObservables...](const Subscriber<Output>& subscriber) {
+            auto latest = std::make_shared<Latest>();
+            Subscription subscriptions;
+
+            // Subscribe to each latest observable and store its values in the matching slot
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                (subscriptions.add(latestObservables.subscribe(Observer<Us>(
+                    [latest](const Us& value) {
+                        latest->template store<Is>(value);
+                    },
+                    [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) {
+                        subscriber->error(err);
+                    }
+                ))), ...);
+            }(std::index_sequence_for<Us...>{});
+
+            Observer<T> combinedObserver(
+                [emit, latest, subscriber = subscriber.shared_from_this()](const T& t) {
+                    if (latest->ready()) {
+                        emit(*subscriber, t, *latest);
+                    }
+                },
+                [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { subscriber->error(err); },
+                [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
+            );
+
+            subscriptions.add(sourceObservable.subscribe(combinedObserver));
+            return [subscriptions]() mutable {
+                subscriptions.unsubscribe();
             };
         });
     };
 }
 
+} // namespace impl
+
 /**
  * @brief Combines the source observable with the latest values from one or more other observables.
  * 
@@ -290,7 +3686,8 @@ Operator<T, T> merge(const Observable<Ts>&... observables) {
  * 
  * The additional observables are **only sampled when the source emits**. If a sampled 
  * observable has not emitted any values yet, the source emission is ignored until at least one value 
- * is available for each observable.
+ * is available for each observable. Whether all are available is tracked with a counter, so the
+ * check costs the same for any number of observables.
  * 
  * The resulting observable **only completes when the source observable completes**, not when 
  * any of the latest observables complete. The latest observables can complete without affecting 
@@ -298,69 +3695,74 @@ Operator<T, T> merge(const Observable<Ts>&... observables) {
  * 
  * Errors from either the source or the latest observables will be forwarded to the resulting observable.
  * 
+ * The latest values are not synchronized; use `withLatestFromConcurrent` if the observables
+ * emit on different threads.
+ * 
  * @tparam T The type of values emitted by the source observable.
  * @param latestObservables One or more observables whose latest values will be combined with the source.
  * @return Operator<T, std::tuple<T, Us...>> A function that applies the combination logic to an observable.
  */
 template <typename T, typename... Us>
 Operator<T, std::tuple<T, Us...>> withLatestFrom(Observable<Us>... latestObservables) {
-    return [latestObservables...](const Observable<T>& sourceObservable) {
-        return impl::ObservableFactory<std::tuple<T, Us...>>(
-            [sourceObservable, latestObservables...](const Subscriber<std::tuple<T, Us...>>& subscriber) {
-                auto latestValues = std::make_shared<std::tuple<std::optional<Us>...>>();
-
-                // Function to check if all values in the tuple are set
-                auto allSet = [latestValues]() {
-                    return std::apply([](auto&... values) {
-                        return (... && values.has_value());
-                    }, *latestValues);
-                };
+    using Output = std::tuple<T, Us...>;
 
-                Subscription subscriptions;
+    return impl::withLatestFrom<Output, impl::LatestValues<Us...>, T>(
+        [](const Subscriber<Output>& subscriber, const T& t, const impl::LatestValues<Us...>& latest) {
+            subscriber.next(latest.apply([&t](const Us&... values) { return Output(t, values...); }));
+        },
+        std::move(latestObservables)...
+    );
+}
 
-                // Subscribe to each latestObservable and update its corresponding value in latestValues
-                auto subscribeLatest = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-                    (void)std::initializer_list<int>{
-                        (subscriptions.add(
-                            latestObservables.subscribe(
-                                Observer<Us>(
-                                    [latestValues](const Us& value) {
-                                        std::get<Is>(*latestValues) = value;
-                                    },
-                                    [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { 
-                                        subscriber->error(err);
-                                    }
-                                )
-                            )
-                        ), 0)... // Using comma operator to expand the parameter pack
-                    };
-                };
+/**
+ * @brief Combines the source observable with the latest values from other observables, without copying them.
+ *
+ * Like `withLatestFrom`, but emits a tuple of references to the source value and to the
+ * stored latest values instead of copies. The references are only valid during `next`.
+ *
+ * The latest values are not synchronized; the observables must emit on the same thread.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @param latestObservables One or more observables whose latest values will be combined with the source.
+ * @return Operator<T, std::tuple<const T&, const Us&...>> A function that applies the combination logic to an observable.
+ */
+template <typename T, typename... Us>
+Operator<T, std::tuple<const T&, const Us&...>> withLatestFromRef(Observable<Us>... latestObservables) {
+    using Output = std::tuple<const T&, const Us&...>;
 
-                // Create observers dynamically for each latest observable
-                subscribeLatest(std::index_sequence_for<Us...>{});
+    return impl::withLatestFrom<Output, impl::LatestValues<Us...>, T>(
+        [](const Subscriber<Output>& subscriber, const T& t, const impl::LatestValues<Us...>& latest) {
+            latest.apply([&](const Us&... values) { subscriber.next(Output(t, values...)); });
+        },
+        std::move(latestObservables)...
+    );
+}
 
-                // Subscribe to the source observable
-                Observer<T> combinedObserver(
-                    [subscriber = subscriber.shared_from_this(), latestValues, allSet](const T& t) {
-                        if (allSet()) {
-                            subscriber->next(
-                                std::tuple_cat(std::make_tuple(t), 
-                                    std::apply([](auto&... values) { return std::make_tuple(values.value()...); }, *latestValues)
-                                )
-                            );
-                        }
-                    },
-                    [subscriber = subscriber.shared_from_this()](const std::exception_ptr& err) { subscriber->error(err); },
-                    [subscriber = subscriber.shared_from_this()]() { subscriber->complete(); }
-                );
+/**
+ * @brief Combines the source observable with the latest values from observables that emit on other threads.
+ *
+ * Like `withLatestFrom`, but the latest observables may emit on any thread, concurrently
+ * with the source. Each latest value is kept in a seqlocked slot: storing it never waits,
+ * and the source reads a consistent copy of each value without taking a lock. This suits
+ * enriching a high-rate stream with values that are updated from elsewhere. The values of
+ * one emission are each consistent, but may stem from different moments.
+ *
+ * @tparam T The type of values emitted by the source observable.
+ * @tparam Us The types of the latest values; they must be trivially copyable.
+ * @param latestObservables One or more observables whose latest values will be combined with the source.
+ * @return Operator<T, std::tuple<T, Us...>> A function that applies the combination logic to an observable.
+ */
+template <typename T, typename... Us>
+requires (std::is_trivially_copyable_v<Us> && ...)
+Operator<T, std::tuple<T, Us...>> withLatestFromConcurrent(Observable<Us>... latestObservables) {
+    using Output = std::tuple<T, Us...>;
 
-                subscriptions.add(sourceObservable.subscribe(combinedObserver));
-                return [subscriptions]() mutable {
-                    subscriptions.unsubscribe();
-                };
-            }
-        );
-    };
+    return impl::withLatestFrom<Output, impl::ConcurrentLatestValues<Us...>, T>(
+        [](const Subscriber<Output>& subscriber, const T& t, const impl::ConcurrentLatestValues<Us...>& latest) {
+            subscriber.next(latest.apply([&t](const Us&... values) { return Output(t, values...); }));
+        },
+        std::move(latestObservables)...
+    );
 }
 
 } // namespace RxLite
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <climits>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace RxLite {
+
+/**
+ * @brief Describes which CPUs a scheduler's worker thread runs on and where its memory lives.
+ *
+ * An `Affinity` is a set of CPUs and, optionally, a NUMA node. Schedulers with a worker thread,
+ * such as `EventLoopScheduler` and `Reactor`, accept one on construction. The worker is pinned
+ * to the CPUs and prefers memory of the node, so buffers it allocates itself are node-local
+ * (first touch). The scheduler's own state, including its timer queue, is placed on the node
+ * with `mbind`.
+ *
+ * Pinning is best effort: if the operating system rejects the CPU set or the memory policy,
+ * e.g. because the CPUs are not available to the process, the worker runs unpinned. Affinity
+ * is only applied on Linux and ignored elsewhere.
+ */
+class Affinity {
+public:
+    static constexpr int MaxCpus = 1024;
+    static constexpr int MaxNodes = 1024;
+
+    /**
+     * @brief Constructs an affinity that does not pin anything.
+     */
+    Affinity() = default;
+
+    /**
+     * @brief Constructs an affinity for the given CPUs and, optionally, NUMA node.
+     *
+     * @param cpus The CPUs the worker thread may run on. Empty means all CPUs.
+     * @param node The NUMA node whose memory is preferred, if any.
+     * @throws std::invalid_argument If a CPU or node number is out of range.
+     */
+    explicit Affinity(std::vector<int> cpus, std::optional<int> node = std::nullopt)
+        : cpuSet(std::move(cpus)), memoryNode(node) {
+        for (int cpu : cpuSet) {
+            if (cpu < 0 || cpu >= MaxCpus) {
+                throw std::invalid_argument("Affinity: invalid CPU " + std::to_string(cpu));
+            }
+        }
+
+        if (memoryNode && (*memoryNode < 0 || *memoryNode >= MaxNodes)) {
+            throw std::invalid_argument("Affinity: invalid NUMA node " + std::to_string(*memoryNode));
+        }
+    }
+
+    /**
+     * @brief Constructs an affinity for all CPUs and the memory of a NUMA node.
+     *
+     * @param node The NUMA node.
+     * @return Affinity An affinity pinning to the CPUs of the node.
+     * @throws std::invalid_argument If the node does not exist.
+     */
+    static Affinity node(int node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        if (node < 0 || !std::getline(file, list)) {
+            throw std::invalid_argument("Affinity: unknown NUMA node " + std::to_string(node));
+        }
+
+        return Affinity(parseCpuList(list), node);
+    }
+
+    /**
+     * @brief Returns the CPUs to pin to; empty if the affinity does not restrict CPUs.
+     */
+    const std::vector<int>& cpus() const {
+        return cpuSet;
+    }
+
+    /**
+     * @brief Returns the NUMA node whose memory is preferred, if any.
+     */
+    std::optional<int> numaNode() const {
+        return memoryNode;
+    }
+
+private:
+    std::vector<int> cpuSet;
+    std::optional<int> memoryNode;
+
+    // Parses the kernel's list format, e.g. "0-3,8,10-11"
+    static std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> cpus;
+        std::size_t position = 0;
+
+        while (position < list.size()) {
+            std::size_t end = list.find(',', position);
+            std::string range = list.substr(position, end == std::string::npos ? std::string::npos : end - position);
+            position = end == std::string::npos ? list.size() : end + 1;
+
+            if (range.empty()) {
+                continue;
+            }
+
+            std::size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        }
+
+        return cpus;
+    }
+};
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+#if defined(__linux__)
+inline std::vector<unsigned long> nodeMask(int node) {
+    constexpr int Bits = sizeof(unsigned long) * CHAR_BIT;
+    std::vector<unsigned long> mask(node / Bits + 1, 0);
+    mask[node / Bits] |= 1ul << (node % Bits);
+    return mask;
+}
+#endif
+
+// Applies an affinity to the calling thread
+inline void applyAffinity(const Affinity& affinity) {
+#if defined(__linux__)
+    if (!affinity.cpus().empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : affinity.cpus()) {
+            CPU_SET(cpu, &set);
+        }
+
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+    }
+
+    if (std::optional<int> node = affinity.numaNode()) {
+        std::vector<unsigned long> mask = nodeMask(*node);
+        ::syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask.data(), mask.size() * sizeof(unsigned long) * CHAR_BIT + 1);
+    }
+#else
+    (void) affinity;
+#endif
+}
+
+// Allocates whole pages that prefer the memory of a NUMA node
+template <typename T>
+class NodeAllocator {
+public:
+    using value_type = T;
+
+    explicit NodeAllocator(int node) : node(node) {}
+
+    template <typename U>
+    NodeAllocator(const NodeAllocator<U>& other) : node(other.node) {}
+
+    T* allocate(std::size_t n) {
+#if defined(__linux__)
+        void* memory = ::mmap(nullptr, bytes(n), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        std::vector<unsigned long> mask = nodeMask(node);
+        ::syscall(SYS_mbind, memory, bytes(n), MPOL_PREFERRED, mask.data(), mask.size() * sizeof(unsigned long) * CHAR_BIT + 1, 0);
+        return static_cast<T*>(memory);
+#else
+        return std::allocator<T>().allocate(n);
+#endif
+    }
+
+    void deallocate(T* p, std::size_t n) {
+#if defined(__linux__)
+        ::munmap(p, bytes(n));
+#else
+        std::allocator<T>().deallocate(p, n);
+#endif
+    }
+
+    template <typename U>
+    bool operator==(const NodeAllocator<U>& other) const {
+        return node == other.node;
+    }
+
+private:
+    int node;
+
+    static std::size_t bytes(std::size_t n) {
+        std::size_t page = 4096;
+#if defined(__linux__)
+        page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+        return (n * sizeof(T) + page - 1) / page * page;
+    }
+
+    template <typename U>
+    friend class NodeAllocator;
+};
+
+// Creates the shared state of a scheduler, on the memory of the affinity's node if it has one
+template <typename Context, typename... Args>
+std::shared_ptr<Context> makeContext(const Affinity& affinity, Args&&... args) {
+    if (std::optional<int> node = affinity.numaNode()) {
+        return std::allocate_shared<Context>(NodeAllocator<Context>(*node), std::forward<Args>(args)...);
+    }
+
+    return std::make_shared<Context>(std::forward<Args>(args)...);
+}
+
+} // namespace impl
+
+} // namespace RxLite
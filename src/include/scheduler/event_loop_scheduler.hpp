@@ -0,0 +1,163 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <thread>
+
+#include "affinity.hpp"
+#include "timer_queue.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief A Scheduler that runs all actions on a single, dedicated thread.
+ *
+ * `EventLoopScheduler` starts a worker thread that sleeps until the next timer is due and
+ * then runs all expired actions, one after another. Actions scheduled on the same loop
+ * therefore never run concurrently. The pending timers are kept in a pluggable backend:
+ * the default `HeapTimerQueue`, or `TimerWheel` for very large numbers of timers.
+ *
+ * The worker thread can be pinned to CPUs and a NUMA node with an `Affinity`, so that the
+ * actions, and the observers they call, run close to the memory they work on.
+ *
+ * The worker thread stops once the last copy of the scheduler is destroyed; pending
+ * actions are dropped.
+ *
+ * @tparam TimerQueue The timer backend, e.g. `HeapTimerQueue` or `TimerWheel`.
+ */
+template <typename TimerQueue = HeapTimerQueue>
+class EventLoopScheduler;
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+template <typename TimerQueue>
+class EventLoopContext : public TimerQueueContext<TimerQueue> {
+public:
+    template <typename... Args>
+    explicit EventLoopContext(Args&&... args) : TimerQueueContext<TimerQueue>(std::forward<Args>(args)...) {}
+
+    // Starts the worker; it only refers to the context through a weak pointer, see `loop()`
+    static std::shared_ptr<EventLoopContext> start(std::shared_ptr<EventLoopContext> context, const Affinity& affinity) {
+        context->worker = std::thread([weakContext = std::weak_ptr<EventLoopContext>(context), affinity]() {
+            applyAffinity(affinity);
+            loop(weakContext);
+        });
+
+        return context;
+    }
+
+    ~EventLoopContext() override {
+        {
+            std::unique_lock lock(this->mutex);
+            stopped = true;
+        }
+
+        wakeup.notify_one();
+
+        if (worker.get_id() == std::this_thread::get_id()) {
+            // The last handle was dropped by an action running on the loop, which returns right after
+            worker.detach();
+        } else if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    SchedulerBase::Clock::time_point now() const override {
+        return SchedulerBase::Clock::now();
+    }
+
+protected:
+    void onArmed(SchedulerBase::Clock::time_point due) override {
+        if (due < sleepingUntil) {
+            sleepingUntil = due;
+            wakeup.notify_one();
+        }
+    }
+
+private:
+    std::thread worker;
+    std::condition_variable wakeup;
+    SchedulerBase::Clock::time_point sleepingUntil = SchedulerBase::Clock::time_point::min();
+    bool stopped = false;
+
+    // Actions run while the loop holds a handle, so an action that drops the last other
+    // handle cannot free the context under the loop; the context is then destroyed on this
+    // thread once the batch is done, and the loop finds the weak pointer expired. While it
+    // sleeps, the loop holds no handle, so the context can only be destroyed by another
+    // thread, which joins the worker before the members go away.
+    static void loop(const std::weak_ptr<EventLoopContext>& weakContext) {
+        std::vector<ExpiredTimer> batch;
+
+        while (std::shared_ptr<EventLoopContext> self = weakContext.lock()) {
+            {
+                std::unique_lock lock(self->mutex);
+                self->queue.expire(SchedulerBase::Clock::now(), batch);
+            }
+
+            if (!batch.empty()) {
+                self->run(batch);
+                batch.clear();
+                continue;
+            }
+
+            EventLoopContext* context = self.get();
+            self.reset();
+            if (weakContext.expired()) {
+                return;
+            }
+
+            std::unique_lock lock(context->mutex);
+            if (context->stopped) {
+                return;
+            }
+
+            // Timers armed since the last check are seen here, later ones wake the loop up
+            std::optional<SchedulerBase::Clock::time_point> due = context->queue.nextDue();
+            context->sleepingUntil = due.value_or(SchedulerBase::Clock::time_point::max());
+
+            if (!due) {
+                context->wakeup.wait(lock);
+            } else if (*due > SchedulerBase::Clock::now()) {
+                context->wakeup.wait_until(lock, *due);
+            }
+
+            context->sleepingUntil = SchedulerBase::Clock::time_point::min();
+        }
+    }
+};
+
+} // namespace impl
+
+template <typename TimerQueue>
+class EventLoopScheduler : public Scheduler {
+public:
+    /**
+     * @brief Starts a new event loop.
+     *
+     * @param args Arguments forwarded to the timer backend, e.g. the tick resolution of a `TimerWheel`.
+     */
+    template <typename... Args>
+    requires std::constructible_from<TimerQueue, Args...>
+    explicit EventLoopScheduler(Args&&... args)
+        : EventLoopScheduler(Affinity(), std::forward<Args>(args)...) {}
+
+    /**
+     * @brief Starts a new event loop whose worker thread is pinned according to `affinity`.
+     *
+     * @param affinity The CPUs and NUMA node of the worker thread and the loop's state.
+     * @param args Arguments forwarded to the timer backend, e.g. the tick resolution of a `TimerWheel`.
+     */
+    template <typename... Args>
+    requires std::constructible_from<TimerQueue, Args...>
+    explicit EventLoopScheduler(const Affinity& affinity, Args&&... args)
+        : Scheduler(impl::EventLoopContext<TimerQueue>::start(
+            impl::makeContext<impl::EventLoopContext<TimerQueue>>(affinity, std::forward<Args>(args)...), affinity)) {}
+};
+
+} // namespace RxLite
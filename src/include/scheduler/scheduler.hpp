@@ -0,0 +1,274 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+
+namespace RxLite {
+
+/**
+ * @brief Controls when and where scheduled work is executed.
+ *
+ * A `Scheduler` is a lightweight handle to an execution context. It knows the current
+ * time of that context (which may be virtual) and can run actions either as soon as
+ * possible or at a given point in time. Copies of a scheduler share the same context,
+ * so schedulers can be passed to operators by value.
+ */
+class Scheduler;
+
+/**
+ * @brief A handle to a unit of work scheduled on a Scheduler.
+ *
+ * A `Timer` can be cancelled before it fires and can be rescheduled to a new due time.
+ * Rescheduling reuses the action stored in the timer, so periodic or frequently moved
+ * timers (e.g. debouncing) do not allocate per reschedule.
+ */
+class Timer;
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+class ScheduleSender;
+
+struct TimerLink {
+    TimerLink* prev = nullptr;
+    TimerLink* next = nullptr;
+};
+
+struct TimerSlot : TimerLink {
+    const std::function<void()> action;
+    std::chrono::steady_clock::time_point due;
+    std::uint64_t generation = 0;
+    std::atomic<bool> armed = false;
+
+    // Bookkeeping for timer queues that link slots intrusively (see TimerWheel)
+    std::uint64_t tick = 0;
+    std::uint32_t bucket = 0;
+    std::shared_ptr<TimerSlot> retained;
+
+    // Position in the array of a HeapTimerQueue, so that moving a timer sifts it in place
+    std::size_t heapIndex = 0;
+
+    explicit TimerSlot(std::function<void()> action) : action(std::move(action)) {}
+};
+
+class SchedulerBase {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    virtual ~SchedulerBase() = default;
+
+    virtual Clock::time_point now() const = 0;
+
+    virtual void arm(const std::shared_ptr<TimerSlot>& slot, Clock::time_point due) = 0;
+
+    virtual void disarm(const std::shared_ptr<TimerSlot>& slot) = 0;
+
+    // Returns true if the caller may run work inline right now, in which case it must call
+    // `leave()` afterwards, or `abandon()` if that work throws.
+    virtual bool enter() {
+        return false;
+    }
+
+    virtual void leave() {}
+
+    virtual void abandon() {}
+};
+
+} // namespace impl
+
+class Timer {
+public:
+    /**
+     * @brief Constructs an empty Timer that is not bound to any scheduler.
+     */
+    Timer() = default;
+
+    /**
+     * @brief Cancels the timer if it has not fired yet.
+     *
+     * Cancelling an already fired or cancelled timer has no effect.
+     */
+    void cancel() const {
+        if (auto context = weakContext.lock()) {
+            context->disarm(slot);
+        }
+    }
+
+    /**
+     * @brief Moves the timer to a new due time.
+     *
+     * If the timer is still pending it is moved, otherwise it is armed again.
+     *
+     * @param due The point in time (of the owning scheduler's clock) at which the action runs.
+     */
+    void reschedule(std::chrono::steady_clock::time_point due) const {
+        if (auto context = weakContext.lock()) {
+            context->arm(slot, due);
+        }
+    }
+
+    /**
+     * @brief Moves the timer to run after the given delay, measured from the scheduler's current time.
+     *
+     * @param delay The delay after which the action runs.
+     */
+    void rescheduleAfter(std::chrono::steady_clock::duration delay) const {
+        if (auto context = weakContext.lock()) {
+            context->arm(slot, context->now() + delay);
+        }
+    }
+
+    /**
+     * @brief Checks whether the timer is waiting to fire.
+     *
+     * @return true if the timer is armed and has neither fired nor been cancelled.
+     */
+    bool isPending() const {
+        return slot && slot->armed.load(std::memory_order_acquire);
+    }
+
+private:
+    std::weak_ptr<impl::SchedulerBase> weakContext;
+    std::shared_ptr<impl::TimerSlot> slot;
+
+    Timer(std::weak_ptr<impl::SchedulerBase> weakContext, std::shared_ptr<impl::TimerSlot> slot)
+        : weakContext(std::move(weakContext)), slot(std::move(slot)) {}
+
+    friend class Scheduler;
+};
+
+class Scheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using Duration = Clock::duration;
+    using Action = std::function<void()>;
+
+    /**
+     * @brief Returns the current time of this scheduler's clock.
+     *
+     * @return TimePoint The current (possibly virtual) time.
+     */
+    TimePoint now() const {
+        return sharedContext->now();
+    }
+
+    /**
+     * @brief Schedules an action to run as soon as possible.
+     *
+     * @param action The action to run.
+     * @return Timer A handle that can be used to cancel the action.
+     */
+    Timer schedule(Action action) const {
+        return scheduleAt(now(), std::move(action));
+    }
+
+    /**
+     * @brief Returns a sender that completes on this scheduler.
+     *
+     * This makes every RxLite scheduler usable as a sender/receiver (P2300) scheduler.
+     * The returned sender completes with `set_value()` as soon as the scheduler gets to it.
+     * Its operation state embeds the timer it arms, so starting and completing it does not
+     * allocate.
+     *
+     * Requires `execution.hpp`, which defines the sender.
+     *
+     * @return A sender that completes on this scheduler.
+     */
+    template <typename Sender = impl::ScheduleSender>
+    Sender schedule() const {
+        return Sender(sharedContext);
+    }
+
+    /**
+     * @brief Runs a function as soon as possible, without a handle to cancel it.
+     *
+     * Schedulers that may run work inline (such as `TrampolineScheduler` when it is not
+     * already draining) invoke the function directly, without allocating a timer. All
+     * other schedulers fall back to `schedule()`.
+     *
+     * @param func The function to run.
+     */
+    template <typename Func>
+    requires std::invocable<Func&>
+    void dispatch(Func&& func) const {
+        if (!sharedContext->enter()) {
+            schedule(Action(std::forward<Func>(func)));
+            return;
+        }
+
+        try {
+            std::invoke(func);
+        } catch (...) {
+            sharedContext->abandon();
+            throw;
+        }
+
+        sharedContext->leave();
+    }
+
+    /**
+     * @brief Schedules an action to run after the given delay.
+     *
+     * @param delay The delay, measured from `now()`.
+     * @param action The action to run.
+     * @return Timer A handle that can be used to cancel or reschedule the action.
+     */
+    Timer scheduleAfter(Duration delay, Action action) const {
+        return scheduleAt(now() + delay, std::move(action));
+    }
+
+    /**
+     * @brief Schedules an action to run at the given point in time.
+     *
+     * Due times in the past run as soon as possible.
+     *
+     * @param due The point in time at which the action runs.
+     * @param action The action to run.
+     * @return Timer A handle that can be used to cancel or reschedule the action.
+     */
+    Timer scheduleAt(TimePoint due, Action action) const {
+        Timer timer = createTimer(std::move(action));
+        timer.reschedule(due);
+        return timer;
+    }
+
+    /**
+     * @brief Creates a timer without arming it.
+     *
+     * The returned timer does nothing until it is armed with `Timer::reschedule()`.
+     * This allows operators to allocate their timer once and move it around afterwards.
+     *
+     * @param action The action to run whenever the timer fires.
+     * @return Timer An unarmed timer bound to this scheduler.
+     */
+    Timer createTimer(Action action) const {
+        return Timer(sharedContext, std::make_shared<impl::TimerSlot>(std::move(action)));
+    }
+
+    /**
+     * @brief Checks whether two schedulers share the same execution context.
+     */
+    bool operator==(const Scheduler& other) const {
+        return sharedContext == other.sharedContext;
+    }
+
+protected:
+    std::shared_ptr<impl::SchedulerBase> sharedContext;
+
+    explicit Scheduler(std::shared_ptr<impl::SchedulerBase> sharedContext)
+        : sharedContext(std::move(sharedContext)) {}
+
+    friend class impl::ScheduleSender;
+};
+
+} // namespace RxLite
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+#include "virtual_time_scheduler.hpp"
+#include "../subject/subject.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief A notification captured at a point in virtual time.
+ *
+ * `Recorded<T>` describes one `next`, `error` or `complete` signal together with the
+ * virtual time at which it was delivered. Two recordings compare equal if they have the
+ * same kind, time and value; errors are compared by kind and time only.
+ *
+ * @tparam T The type of values carried by `next` notifications.
+ */
+template <typename T>
+struct Recorded {
+    enum class Kind { Next, Error, Complete };
+
+    Kind kind;
+    Scheduler::Duration time;
+    std::optional<T> value;
+
+    bool operator==(const Recorded& other) const {
+        return kind == other.kind && time == other.time && value == other.value;
+    }
+};
+
+/**
+ * @brief A VirtualTimeScheduler with marble-diagram helpers.
+ *
+ * Marble diagrams describe observables as strings in which every character is one frame
+ * of virtual time:
+ * - `-` lets one frame pass,
+ * - any other character emits the value mapped to it,
+ * - `|` completes, `#` errors,
+ * - `(ab)` emits several notifications within a single frame,
+ * - `^` marks the subscription point (time zero) of a hot observable,
+ * - spaces are ignored and can be used for alignment.
+ *
+ * Times are measured from the epoch of the virtual clock, so observables subscribed right
+ * after construction line up with the diagrams used to create them.
+ */
+class TestScheduler : public VirtualTimeScheduler {
+public:
+    /**
+     * @brief Constructs a TestScheduler.
+     *
+     * @param frame The amount of virtual time represented by one marble character.
+     */
+    explicit TestScheduler(Duration frame = std::chrono::milliseconds(1))
+        : VirtualTimeScheduler(),
+          frame(frame),
+          sharedRecordings(std::make_shared<std::vector<Subscription>>()) {}
+
+    /**
+     * @brief Parses a marble diagram into the notifications it describes.
+     *
+     * @param marbles The marble diagram.
+     * @param values Maps marble characters to emitted values.
+     * @return std::vector<Recorded<T>> The described notifications, ordered by time.
+     */
+    template <typename T>
+    std::vector<Recorded<T>> parseMarbles(std::string_view marbles, const std::map<char, T>& values = {}) const {
+        std::vector<Recorded<T>> recorded;
+        std::ptrdiff_t position = 0;
+        std::ptrdiff_t zero = 0;
+        std::optional<std::ptrdiff_t> groupStart;
+
+        auto emit = [&](typename Recorded<T>::Kind kind, std::optional<T> value) {
+            std::ptrdiff_t at = groupStart ? *groupStart : position;
+            recorded.push_back(Recorded<T>{kind, at * frame, std::move(value)});
+        };
+
+        for (char c : marbles) {
+            switch (c) {
+            case ' ':
+                continue;
+            case '^':
+                zero = position;
+                break;
+            case '-':
+                break;
+            case '(':
+                groupStart = position;
+                continue;
+            case ')':
+                groupStart.reset();
+                break;
+            case '|':
+                emit(Recorded<T>::Kind::Complete, std::nullopt);
+                break;
+            case '#':
+                emit(Recorded<T>::Kind::Error, std::nullopt);
+                break;
+            default: {
+                auto it = values.find(c);
+                if (it == values.end()) {
+                    throw std::invalid_argument(std::string("no value for marble '") + c + "'");
+                }
+                emit(Recorded<T>::Kind::Next, it->second);
+                break;
+            }
+            }
+
+            if (!groupStart) {
+                position++;
+            }
+        }
+
+        for (auto& notification : recorded) {
+            notification.time -= zero * frame;
+        }
+
+        return recorded;
+    }
+
+    /**
+     * @brief Creates a cold observable from a marble diagram.
+     *
+     * Every subscription replays the diagram, with frame zero at the time of subscribing.
+     *
+     * @param marbles The marble diagram.
+     * @param values Maps marble characters to emitted values.
+     * @param error The error delivered for `#`.
+     * @return Observable<T> An observable that plays the diagram per subscription.
+     */
+    template <typename T>
+    Observable<T> createColdObservable(std::string_view marbles,
+                                       const std::map<char, T>& values = {},
+                                       std::exception_ptr error = nullptr) const {
+        std::vector<Recorded<T>> messages = parseMarbles<T>(marbles, values);
+
+        return Observable<T>([scheduler = *this, messages, error](const Subscriber<T>& subscriber) -> TeardownLogic {
+            auto timers = std::make_shared<std::vector<Timer>>();
+            TimePoint start = scheduler.now();
+
+            for (const auto& message : messages) {
+                timers->push_back(scheduler.scheduleAt(start + message.time,
+                    [subscriber = subscriber.shared_from_this(), message, error]() {
+                        deliver(*subscriber, message, error);
+                    }
+                ));
+            }
+
+            return [timers]() {
+                for (const auto& timer : *timers) {
+                    timer.cancel();
+                }
+            };
+        });
+    }
+
+    /**
+     * @brief Creates a hot observable from a marble diagram.
+     *
+     * The diagram starts playing immediately, relative to the epoch of the virtual clock,
+     * and is shared by all subscribers. Notifications before `^` are dropped.
+     *
+     * @param marbles The marble diagram.
+     * @param values Maps marble characters to emitted values.
+     * @param error The error delivered for `#`.
+     * @return Observable<T> An observable that plays the diagram once, for all subscribers.
+     */
+    template <typename T>
+    Observable<T> createHotObservable(std::string_view marbles,
+                                      const std::map<char, T>& values = {},
+                                      std::exception_ptr error = nullptr) const {
+        Subject<T> subject;
+
+        for (const auto& message : parseMarbles<T>(marbles, values)) {
+            if (message.time < Duration::zero()) {
+                continue;
+            }
+
+            scheduleAt(TimePoint{} + message.time, [subject, message, error]() {
+                switch (message.kind) {
+                case Recorded<T>::Kind::Next: subject.next(*message.value); break;
+                case Recorded<T>::Kind::Error: subject.error(error); break;
+                case Recorded<T>::Kind::Complete: subject.complete(); break;
+                }
+            });
+        }
+
+        return subject;
+    }
+
+    /**
+     * @brief Subscribes to an observable and records everything it delivers.
+     *
+     * The subscription is kept alive by the scheduler. The returned recording fills up
+     * as virtual time advances.
+     *
+     * @param observable The observable to record.
+     * @return std::shared_ptr<const std::vector<Recorded<T>>> The notifications received so far.
+     */
+    template <typename T>
+    std::shared_ptr<const std::vector<Recorded<T>>> record(const Observable<T>& observable) const {
+        auto recorded = std::make_shared<std::vector<Recorded<T>>>();
+
+        // Pending timers keep the recorder alive, so it must not keep the scheduler alive in turn
+        std::weak_ptr<impl::SchedulerBase> weakContext = sharedContext;
+        auto elapsed = [weakContext]() {
+            auto context = weakContext.lock();
+            return context ? context->now().time_since_epoch() : Duration::zero();
+        };
+
+        Observer<T> recorder(
+            [recorded, elapsed](const T& t) {
+                recorded->push_back(Recorded<T>{Recorded<T>::Kind::Next, elapsed(), t});
+            },
+            [recorded, elapsed](const std::exception_ptr&) {
+                recorded->push_back(Recorded<T>{Recorded<T>::Kind::Error, elapsed(), std::nullopt});
+            },
+            [recorded, elapsed]() {
+                recorded->push_back(Recorded<T>{Recorded<T>::Kind::Complete, elapsed(), std::nullopt});
+            }
+        );
+
+        sharedRecordings->push_back(observable.subscribe(recorder));
+        return recorded;
+    }
+
+    /**
+     * @brief Returns the virtual time that has passed since the epoch.
+     *
+     * @return Duration The elapsed virtual time.
+     */
+    Duration elapsed() const {
+        return now().time_since_epoch();
+    }
+
+private:
+    Duration frame;
+    std::shared_ptr<std::vector<Subscription>> sharedRecordings;
+
+    template <typename T>
+    static void deliver(const Subscriber<T>& subscriber, const Recorded<T>& message, const std::exception_ptr& error) {
+        switch (message.kind) {
+        case Recorded<T>::Kind::Next: subscriber.next(*message.value); break;
+        case Recorded<T>::Kind::Error: subscriber.error(error); break;
+        case Recorded<T>::Kind::Complete: subscriber.complete(); break;
+        }
+    }
+};
+
+} // namespace RxLite
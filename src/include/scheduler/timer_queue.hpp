@@ -0,0 +1,232 @@
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "scheduler.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+struct ExpiredTimer {
+    std::shared_ptr<TimerSlot> slot;
+    std::uint64_t generation;
+};
+
+} // namespace impl
+
+/**
+ * @brief A timer backend that keeps pending timers in a binary heap.
+ *
+ * Timers fire in exact due-time order, and timers with equal due times fire in the order
+ * they were armed. Scheduling, rescheduling and cancelling cost O(log n): every timer
+ * records its position in the heap, so it is sifted in place when it moves or is removed.
+ * The heap thus holds one entry per pending timer, however often timers move.
+ *
+ * This is the default backend of all schedulers. For very large numbers of concurrent
+ * timers, see `TimerWheel`.
+ */
+class HeapTimerQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void push(const std::shared_ptr<impl::TimerSlot>& slot, Clock::time_point) {
+        heap.push_back(Entry{slot->due, sequence++, slot->generation, slot});
+        siftUp(heap.size() - 1);
+    }
+
+    void remove(const std::shared_ptr<impl::TimerSlot>& slot) {
+        // An armed timer may already have expired and be waiting to run
+        std::size_t index = slot->heapIndex;
+        if (index >= heap.size() || heap[index].slot != slot) {
+            return;
+        }
+
+        Entry last = std::move(heap.back());
+        heap.pop_back();
+        if (index < heap.size()) {
+            place(index, std::move(last));
+            siftDown(siftUp(index));
+        }
+    }
+
+    void expire(Clock::time_point now, std::vector<impl::ExpiredTimer>& expired) {
+        while (!heap.empty() && heap.front().due <= now) {
+            if (isCurrent(heap.front())) {
+                expired.push_back(impl::ExpiredTimer{heap.front().slot, heap.front().generation});
+            }
+
+            popFront();
+        }
+    }
+
+    std::optional<Clock::time_point> nextDue() {
+        while (!heap.empty() && !isCurrent(heap.front())) {
+            popFront();
+        }
+
+        if (heap.empty()) {
+            return std::nullopt;
+        }
+
+        return heap.front().due;
+    }
+
+    /**
+     * @brief Returns the number of pending timers.
+     */
+    std::size_t size() const {
+        return heap.size();
+    }
+
+private:
+    struct Entry {
+        Clock::time_point due;
+        std::uint64_t sequence;
+        std::uint64_t generation;
+        std::shared_ptr<impl::TimerSlot> slot;
+    };
+
+    std::vector<Entry> heap;
+    std::uint64_t sequence = 0;
+
+    // Entries are removed when their timer moves, unless it was disarmed by a context that
+    // cannot reach this queue (see TrampolineScheduler); those are dropped once they surface
+    static bool isCurrent(const Entry& entry) {
+        return entry.generation == entry.slot->generation && entry.slot->armed.load(std::memory_order_relaxed);
+    }
+
+    static bool earlier(const Entry& lhs, const Entry& rhs) {
+        return lhs.due != rhs.due ? lhs.due < rhs.due : lhs.sequence < rhs.sequence;
+    }
+
+    void place(std::size_t index, Entry&& entry) {
+        entry.slot->heapIndex = index;
+        heap[index] = std::move(entry);
+    }
+
+    void popFront() {
+        Entry last = std::move(heap.back());
+        heap.pop_back();
+        if (!heap.empty()) {
+            place(0, std::move(last));
+            siftDown(0);
+        }
+    }
+
+    // Both return the final position of the entry
+    std::size_t siftUp(std::size_t index) {
+        Entry entry = std::move(heap[index]);
+        while (index > 0) {
+            std::size_t parent = (index - 1) / 2;
+            if (!earlier(entry, heap[parent])) {
+                break;
+            }
+
+            place(index, std::move(heap[parent]));
+            index = parent;
+        }
+
+        place(index, std::move(entry));
+        return index;
+    }
+
+    std::size_t siftDown(std::size_t index) {
+        Entry entry = std::move(heap[index]);
+        while (true) {
+            std::size_t child = 2 * index + 1;
+            if (child >= heap.size()) {
+                break;
+            }
+
+            if (child + 1 < heap.size() && earlier(heap[child + 1], heap[child])) {
+                child++;
+            }
+
+            if (!earlier(heap[child], entry)) {
+                break;
+            }
+
+            place(index, std::move(heap[child]));
+            index = child;
+        }
+
+        place(index, std::move(entry));
+        return index;
+    }
+};
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+template <typename TimerQueue>
+class TimerQueueContext : public SchedulerBase {
+public:
+    void arm(const std::shared_ptr<TimerSlot>& slot, Clock::time_point due) override {
+        Clock::time_point current = now();
+
+        std::unique_lock lock(mutex);
+        if (slot->armed.load(std::memory_order_relaxed)) {
+            queue.remove(slot);
+        }
+
+        slot->generation++;
+        slot->due = due;
+        slot->armed.store(true, std::memory_order_release);
+        queue.push(slot, current);
+        onArmed(due);
+    }
+
+    void disarm(const std::shared_ptr<TimerSlot>& slot) override {
+        std::unique_lock lock(mutex);
+        if (slot->armed.load(std::memory_order_relaxed)) {
+            queue.remove(slot);
+        }
+
+        slot->generation++;
+        slot->armed.store(false, std::memory_order_release);
+    }
+
+protected:
+    TimerQueue queue;
+    mutable std::mutex mutex;
+
+    template <typename... Args>
+    explicit TimerQueueContext(Args&&... args) : queue(std::forward<Args>(args)...) {}
+
+    // Called with the mutex held whenever a timer is armed
+    virtual void onArmed(Clock::time_point) {}
+
+    // Runs a batch collected by `queue.expire()`. Must be called without holding the mutex;
+    // timers cancelled or rescheduled by earlier actions of the same batch are skipped.
+    void run(const std::vector<ExpiredTimer>& batch) {
+        for (const ExpiredTimer& timer : batch) {
+            {
+                std::unique_lock lock(mutex);
+                if (timer.generation != timer.slot->generation || !timer.slot->armed.load(std::memory_order_relaxed)) {
+                    continue;
+                }
+
+                timer.slot->armed.store(false, std::memory_order_release);
+            }
+
+            timer.slot->action();
+        }
+    }
+};
+
+} // namespace impl
+
+} // namespace RxLite
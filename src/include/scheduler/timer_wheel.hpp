@@ -0,0 +1,252 @@
+#pragma once
+
+#include <array>
+
+#include "timer_queue.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief A timer backend based on a hierarchical hashed timer wheel.
+ *
+ * Time is divided into ticks of a fixed resolution. Timers due within the next 256 ticks
+ * are hashed into the buckets of the innermost wheel; timers further out live in one of four
+ * coarser wheels of 64 buckets each and are cascaded inwards as time approaches them.
+ * Buckets are intrusive lists, so scheduling and cancelling a timer is O(1) and does not
+ * allocate, and all timers of a tick expire as one batch.
+ *
+ * Timers never fire before their due time, but may fire up to one tick late, and timers
+ * within the same tick do not keep their relative order. Delays beyond 2^32 ticks are
+ * supported by re-hashing them when the outermost wheel comes around.
+ *
+ * Use the wheel instead of the default `HeapTimerQueue` when a scheduler holds very many
+ * pending timers that are frequently cancelled or moved, e.g. keyed debouncing or timeouts.
+ */
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Constructs an empty timer wheel.
+     *
+     * @param resolution The duration of one tick.
+     */
+    explicit TimerWheel(Clock::duration resolution = std::chrono::milliseconds(1))
+        : resolution(resolution.count() > 0 ? resolution : Clock::duration(1)) {
+        for (impl::TimerLink& bucket : buckets) {
+            bucket.prev = &bucket;
+            bucket.next = &bucket;
+        }
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    ~TimerWheel() {
+        for (impl::TimerLink& bucket : buckets) {
+            while (bucket.next != &bucket) {
+                unlink(static_cast<impl::TimerSlot*>(bucket.next))->retained.reset();
+            }
+        }
+    }
+
+    void push(const std::shared_ptr<impl::TimerSlot>& slot, Clock::time_point now) {
+        if (count == 0) {
+            // Nothing is pending, so no tick can be skipped by moving forward
+            nextTick = std::max(nextTick, floorTick(now));
+        }
+
+        slot->tick = std::max(ceilTick(slot->due), nextTick);
+        slot->retained = slot;
+        place(slot.get());
+        count++;
+    }
+
+    void remove(const std::shared_ptr<impl::TimerSlot>& slot) {
+        if (slot->next == nullptr) {
+            return;
+        }
+
+        unlink(slot.get());
+        count--;
+        slot->retained.reset();
+    }
+
+    void expire(Clock::time_point now, std::vector<impl::ExpiredTimer>& expired) {
+        const std::uint64_t target = floorTick(now);
+
+        while (nextTick <= target) {
+            if (count == 0) {
+                nextTick = target + 1;
+                break;
+            }
+
+            const std::uint32_t index = nextTick & RootMask;
+
+            if (index != 0 && isRootEmpty()) {
+                // Nothing can fire before the next cascade
+                nextTick = std::min((nextTick | RootMask) + 1, target + 1);
+                continue;
+            }
+
+            if (index == 0) {
+                for (std::uint32_t level = 0; level < Levels; level++) {
+                    if (cascade(level) != 0) {
+                        break;
+                    }
+                }
+            }
+
+            nextTick++;
+
+            impl::TimerLink& bucket = buckets[index];
+            while (bucket.next != &bucket) {
+                impl::TimerSlot* slot = unlink(static_cast<impl::TimerSlot*>(bucket.next));
+                count--;
+                expired.push_back(impl::ExpiredTimer{std::move(slot->retained), slot->generation});
+            }
+        }
+    }
+
+    std::optional<Clock::time_point> nextDue() const {
+        if (count == 0) {
+            return std::nullopt;
+        }
+
+        // Scan the innermost wheel up to the next cascade; beyond that, waking up for
+        // the cascade itself is sufficient.
+        std::uint64_t tick = nextTick;
+        const std::uint64_t cascadeTick = (nextTick | RootMask) + 1;
+        while (tick < cascadeTick && !isOccupied(tick & RootMask)) {
+            tick++;
+        }
+
+        return Clock::time_point(static_cast<Clock::rep>(tick) * resolution);
+    }
+
+    /**
+     * @brief Returns the number of pending timers.
+     */
+    std::size_t size() const {
+        return count;
+    }
+
+private:
+    static constexpr std::uint32_t RootBits = 8;
+    static constexpr std::uint32_t LevelBits = 6;
+    static constexpr std::uint32_t Levels = 4;
+    static constexpr std::uint32_t RootSize = 1u << RootBits;
+    static constexpr std::uint32_t LevelSize = 1u << LevelBits;
+    static constexpr std::uint32_t RootMask = RootSize - 1;
+    static constexpr std::uint32_t LevelMask = LevelSize - 1;
+    static constexpr std::uint32_t BucketCount = RootSize + Levels * LevelSize;
+    static constexpr std::uint64_t MaxDelta = (std::uint64_t(1) << (RootBits + Levels * LevelBits)) - 1;
+
+    const Clock::duration resolution;
+    std::array<impl::TimerLink, BucketCount> buckets;
+    std::array<std::uint64_t, BucketCount / 64> occupied{};
+    std::uint64_t nextTick = 0;
+    std::size_t count = 0;
+
+    std::uint64_t floorTick(Clock::time_point time) const {
+        auto ticks = time.time_since_epoch() / resolution;
+        return ticks > 0 ? static_cast<std::uint64_t>(ticks) : 0;
+    }
+
+    std::uint64_t ceilTick(Clock::time_point time) const {
+        auto sinceEpoch = time.time_since_epoch();
+        if (sinceEpoch <= Clock::duration::zero()) {
+            return 0;
+        }
+
+        auto ticks = sinceEpoch / resolution;
+        return static_cast<std::uint64_t>(ticks) + (sinceEpoch % resolution != Clock::duration::zero() ? 1 : 0);
+    }
+
+    bool isOccupied(std::uint32_t bucket) const {
+        return (occupied[bucket / 64] >> (bucket % 64)) & 1;
+    }
+
+    bool isRootEmpty() const {
+        for (std::uint32_t word = 0; word < RootSize / 64; word++) {
+            if (occupied[word] != 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void place(impl::TimerSlot* slot) {
+        std::uint64_t expires = slot->tick;
+        std::uint64_t delta = expires - nextTick;
+        std::uint32_t bucket;
+
+        if (delta < RootSize) {
+            bucket = expires & RootMask;
+        } else {
+            if (delta > MaxDelta) {
+                // Parked in the outermost wheel and re-hashed once it comes around
+                expires = nextTick + MaxDelta;
+            }
+
+            std::uint32_t level = 0;
+            while (level + 1 < Levels && delta >= (std::uint64_t(1) << (RootBits + (level + 1) * LevelBits))) {
+                level++;
+            }
+
+            bucket = RootSize + level * LevelSize + ((expires >> (RootBits + level * LevelBits)) & LevelMask);
+        }
+
+        impl::TimerLink& head = buckets[bucket];
+        slot->bucket = bucket;
+        slot->prev = head.prev;
+        slot->next = &head;
+        head.prev->next = slot;
+        head.prev = slot;
+        occupied[bucket / 64] |= std::uint64_t(1) << (bucket % 64);
+    }
+
+    impl::TimerSlot* unlink(impl::TimerSlot* slot) {
+        slot->prev->next = slot->next;
+        slot->next->prev = slot->prev;
+        slot->prev = nullptr;
+        slot->next = nullptr;
+
+        impl::TimerLink& head = buckets[slot->bucket];
+        if (head.next == &head) {
+            occupied[slot->bucket / 64] &= ~(std::uint64_t(1) << (slot->bucket % 64));
+        }
+
+        return slot;
+    }
+
+    // Re-hashes the current bucket of the given outer wheel; returns that bucket's index
+    std::uint32_t cascade(std::uint32_t level) {
+        const std::uint32_t index = (nextTick >> (RootBits + level * LevelBits)) & LevelMask;
+        impl::TimerLink& bucket = buckets[RootSize + level * LevelSize + index];
+
+        impl::TimerLink pending;
+        if (bucket.next != &bucket) {
+            pending.next = bucket.next;
+            pending.prev = bucket.prev;
+            pending.next->prev = &pending;
+            pending.prev->next = &pending;
+            bucket.next = &bucket;
+            bucket.prev = &bucket;
+            occupied[(RootSize + level * LevelSize + index) / 64] &= ~(std::uint64_t(1) << ((RootSize + level * LevelSize + index) % 64));
+
+            while (pending.next != &pending) {
+                impl::TimerSlot* slot = static_cast<impl::TimerSlot*>(pending.next);
+                pending.next = slot->next;
+                slot->next->prev = &pending;
+                place(slot);
+            }
+        }
+
+        return index;
+    }
+};
+
+} // namespace RxLite
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <thread>
+
+#include "timer_queue.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief A Scheduler that runs work on the current thread without growing the stack.
+ *
+ * The first action scheduled on a thread runs immediately. Actions scheduled while it runs,
+ * i.e. re-entrantly, are queued instead of invoked, and are drained one after another once
+ * the outermost action returns. Recursive patterns such as an observer that feeds values back
+ * into its own source therefore run iteratively, in constant stack depth.
+ *
+ * Without re-entrancy, `dispatch()` runs its function inline and allocates nothing.
+ * Delayed actions block the calling thread until they are due.
+ *
+ * All trampoline schedulers on a thread share the same queue. Timers returned by this
+ * scheduler must only be cancelled or rescheduled on the thread that created them.
+ */
+class TrampolineScheduler;
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+class TrampolineContext : public SchedulerBase {
+public:
+    Clock::time_point now() const override {
+        return Clock::now();
+    }
+
+    void arm(const std::shared_ptr<TimerSlot>& slot, Clock::time_point due) override {
+        Trampoline& trampoline = local();
+        if (slot->armed.load(std::memory_order_relaxed)) {
+            trampoline.queue.remove(slot);
+        }
+
+        slot->generation++;
+        slot->due = due;
+        slot->armed.store(true, std::memory_order_relaxed);
+        trampoline.queue.push(slot, due);
+
+        if (!trampoline.active) {
+            trampoline.active = true;
+            drain(trampoline);
+        }
+    }
+
+    void disarm(const std::shared_ptr<TimerSlot>& slot) override {
+        slot->generation++;
+        slot->armed.store(false, std::memory_order_relaxed);
+    }
+
+    bool enter() override {
+        Trampoline& trampoline = local();
+        if (trampoline.active) {
+            return false;
+        }
+
+        trampoline.active = true;
+        return true;
+    }
+
+    void leave() override {
+        drain(local());
+    }
+
+    void abandon() override {
+        Trampoline& trampoline = local();
+        trampoline.queue = HeapTimerQueue();
+        trampoline.active = false;
+    }
+
+private:
+    struct Trampoline {
+        HeapTimerQueue queue;
+        std::vector<ExpiredTimer> batch;
+        bool active = false;
+    };
+
+    static Trampoline& local() {
+        thread_local Trampoline trampoline;
+        return trampoline;
+    }
+
+    void drain(Trampoline& trampoline) {
+        try {
+            while (std::optional<Clock::time_point> due = trampoline.queue.nextDue()) {
+                std::this_thread::sleep_until(*due);
+
+                std::vector<ExpiredTimer> batch = std::move(trampoline.batch);
+                trampoline.queue.expire(*due, batch);
+
+                for (const ExpiredTimer& timer : batch) {
+                    if (timer.generation == timer.slot->generation && timer.slot->armed.load(std::memory_order_relaxed)) {
+                        timer.slot->armed.store(false, std::memory_order_relaxed);
+                        timer.slot->action();
+                    }
+                }
+
+                batch.clear();
+                trampoline.batch = std::move(batch);
+            }
+        } catch (...) {
+            abandon();
+            throw;
+        }
+
+        trampoline.active = false;
+    }
+};
+
+} // namespace impl
+
+class TrampolineScheduler : public Scheduler {
+public:
+    TrampolineScheduler() : Scheduler(sharedTrampoline()) {}
+
+private:
+    static std::shared_ptr<impl::SchedulerBase> sharedTrampoline() {
+        static const std::shared_ptr<impl::SchedulerBase> context = std::make_shared<impl::TrampolineContext>();
+        return context;
+    }
+};
+
+} // namespace RxLite
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "timer_queue.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief A Scheduler whose clock only moves when it is told to.
+ *
+ * `VirtualTimeScheduler` never runs work on its own. Scheduled actions are queued by
+ * due time and executed on the calling thread by `advanceBy()`, `advanceTo()` or `flush()`,
+ * which also move the virtual clock forward. Hours of simulated time therefore pass
+ * instantly and deterministically, which makes this scheduler the basis for testing
+ * time-based operators.
+ *
+ * The virtual clock starts at the epoch (`TimePoint{}`).
+ */
+class VirtualTimeScheduler;
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+class VirtualTimeContext : public TimerQueueContext<HeapTimerQueue> {
+public:
+    Clock::time_point now() const override {
+        std::unique_lock lock(mutex);
+        return clock;
+    }
+
+    // Runs every action that shares the earliest due time, if that time is not after `limit`
+    bool runNext(Clock::time_point limit) {
+        std::vector<ExpiredTimer> batch;
+
+        {
+            std::unique_lock lock(mutex);
+            std::optional<Clock::time_point> due = queue.nextDue();
+            if (!due || *due > limit) {
+                return false;
+            }
+
+            // Reuse the storage of the previous batch; a nested call simply starts a new one
+            batch = std::move(spareBatch);
+            clock = std::max(clock, *due);
+            queue.expire(*due, batch);
+        }
+
+        run(batch);
+        batch.clear();
+
+        std::unique_lock lock(mutex);
+        spareBatch = std::move(batch);
+        return true;
+    }
+
+    void advanceTo(Clock::time_point target) {
+        while (runNext(target)) {}
+
+        std::unique_lock lock(mutex);
+        clock = std::max(clock, target);
+    }
+
+    void flush() {
+        while (runNext(Clock::time_point::max())) {}
+    }
+
+    std::size_t pendingCount() const {
+        std::unique_lock lock(mutex);
+        return queue.size();
+    }
+
+private:
+    Clock::time_point clock{};
+    std::vector<ExpiredTimer> spareBatch;
+};
+
+} // namespace impl
+
+class VirtualTimeScheduler : public Scheduler {
+public:
+    VirtualTimeScheduler() : Scheduler(std::make_shared<impl::VirtualTimeContext>()) {}
+
+    /**
+     * @brief Advances the virtual clock by the given duration.
+     *
+     * All actions due until `now() + duration` run in order of their due time, including
+     * actions that are scheduled by other actions within that window.
+     *
+     * @param duration The amount of virtual time to pass.
+     */
+    void advanceBy(Duration duration) const {
+        advanceTo(now() + duration);
+    }
+
+    /**
+     * @brief Advances the virtual clock to the given point in time.
+     *
+     * Runs all actions due until `target`. The clock never moves backwards; passing a
+     * point in the past has no effect.
+     *
+     * @param target The point in virtual time to advance to.
+     */
+    void advanceTo(TimePoint target) const {
+        context().advanceTo(target);
+    }
+
+    /**
+     * @brief Runs all pending actions until the queue is empty.
+     *
+     * The clock is moved to the due time of the last action that ran. Sources that
+     * reschedule themselves forever (e.g. intervals) never drain; use `advanceBy()` for those.
+     */
+    void flush() const {
+        context().flush();
+    }
+
+    /**
+     * @brief Returns the number of actions waiting to run.
+     *
+     * @return std::size_t The number of pending timers.
+     */
+    std::size_t pendingCount() const {
+        return context().pendingCount();
+    }
+
+private:
+    impl::VirtualTimeContext& context() const {
+        return static_cast<impl::VirtualTimeContext&>(*sharedContext);
+    }
+};
+
+} // namespace RxLite
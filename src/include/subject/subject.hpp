@@ -1,10 +1,15 @@
 #pragma once
 
+#include <algorithm>
 #include <list>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <utility>
+#include <vector>
 
 #include "observable.hpp"
+#include "scheduler/scheduler.hpp"
 
 
 namespace RxLite {
@@ -30,6 +35,13 @@ template <typename T>
 class SubscriberManager {
 public:
     void add(const Subscriber<T>& subscriber) {
+        if (isReading()) {
+            // Subscribed from within a broadcast on this thread, which still holds the lock
+            std::unique_lock lock(pendingMutex);
+            pending.push_back(subscriber);
+            return;
+        }
+
         std::unique_lock lock(mutex);
         subscribers.push_back(subscriber);
     }
@@ -41,26 +53,59 @@ public:
             return;
         }
 
+        {
+            std::unique_lock pendingLock(pendingMutex);
+            subscribers.splice(subscribers.end(), pending);
+        }
+
         subscribers.remove_if([](const Subscriber<T>& subscriber) {
             return subscriber.isInactive();
         });
     }
 
-    void clear() {
+    // Drops all subscribers, handing back those that subscribed during the last broadcast
+    std::list<Subscriber<T>> clear() {
         std::unique_lock lock(mutex);
         subscribers.clear();
+
+        std::unique_lock pendingLock(pendingMutex);
+        return std::exchange(pending, {});
     }
 
     template <typename Func>
     requires std::invocable<Func, const std::list<Subscriber<T>>&>
     void read(Func&& func) const {
         std::shared_lock lock(mutex);
-        func(subscribers);
+
+        std::vector<const SubscriberManager*>& reading = readers();
+        reading.push_back(this);
+
+        try {
+            func(subscribers);
+        } catch (...) {
+            reading.pop_back();
+            throw;
+        }
+
+        reading.pop_back();
     }
 
 private:
     std::list<Subscriber<T>> subscribers;
+    std::list<Subscriber<T>> pending;
     mutable std::shared_mutex mutex;
+    std::mutex pendingMutex;
+
+    // The managers currently broadcasting on this thread
+    static std::vector<const SubscriberManager*>& readers() {
+        thread_local std::vector<const SubscriberManager*> reading;
+        return reading;
+    }
+
+    bool isReading() const {
+        const std::vector<const SubscriberManager*>& reading = readers();
+        return std::find(reading.begin(), reading.end(), this) != reading.end();
+    }
 };
 
 template <typename T>
@@ -79,7 +124,7 @@ protected:
         });
     }
 
-    void broadcastError(const std::exception_ptr& err) {
+    void broadcastError(const std::exception_ptr& err) const {
         sharedManager->removeInactive();
         sharedManager->read([&err](const std::list<Subscriber<T>>& subscribers) {
             for (const auto& subscriber : subscribers) {
@@ -96,7 +141,10 @@ protected:
             }
         });
 
-        sharedManager->clear();
+        // Subscribers parked while completing never saw the broadcast
+        for (const auto& subscriber : sharedManager->clear()) {
+            subscriber.complete();
+        }
     }
 };
 
@@ -106,6 +154,24 @@ template <typename T>
 class Subject : public impl::SubjectBase<T>, public Observable<T> {
 public:
     Subject() : impl::SubjectBase<T>(), Observable<T>(createOnSubscribe()) {}
+
+    /**
+     * @brief Constructs a subject that delivers on the given scheduler.
+     *
+     * Values, errors and completion passed to this subject are broadcast to its subscribers
+     * from `delivery` rather than from the calling thread. Delivering on an `EventLoopScheduler`
+     * pinned to a NUMA node keeps the subscribers' callbacks, and the memory they touch, on
+     * that node:
+     *
+     * @code
+     * Subject<int> subject(EventLoopScheduler<>(Affinity::node(1)));
+     * @endcode
+     *
+     * @param delivery The scheduler on which notifications are broadcast.
+     */
+    explicit Subject(Scheduler delivery) : Subject() {
+        this->delivery = std::move(delivery);
+    }
     
     /**
      * @brief Emit a new value to all subscribers.
@@ -115,7 +181,11 @@ public:
      * @param value The new value to broadcast to subscribers.
      */
     void next(const T& value) const {
-        this->broadcastValue(value);
+        if (delivery) {
+            delivery->dispatch([subject = *this, value]() { subject.broadcastValue(value); });
+        } else {
+            this->broadcastValue(value);
+        }
     }
 
     /**
@@ -128,7 +198,11 @@ public:
      * @param err The exception pointer representing the error to be broadcast to subscribers.
      */
     void error(const std::exception_ptr& err) const {
-        this->broadcastError(err);
+        if (delivery) {
+            delivery->dispatch([subject = *this, err]() { subject.broadcastError(err); });
+        } else {
+            this->broadcastError(err);
+        }
     }
 
     /**
@@ -138,10 +212,16 @@ public:
      * After calling `complete()`, any further calls to `next()` or `error()` will have no effect.
      */
     void complete() const {
-        this->broadcastCompletion();
+        if (delivery) {
+            delivery->dispatch([subject = *this]() { subject.broadcastCompletion(); });
+        } else {
+            this->broadcastCompletion();
+        }
     }
 
 private:
+    std::optional<Scheduler> delivery;
+
     std::function<void(const Subscriber<T>&)> createOnSubscribe() {
         return [sharedManager = this->sharedManager](const Subscriber<T>& subscriber) {
             sharedManager->add(subscriber);
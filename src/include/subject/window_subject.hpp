@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "observable.hpp"
+#include "scheduler/scheduler.hpp"
+
+
+namespace RxLite {
+
+/**
+ * @brief Contains implementation details.
+ *
+ * Users of RxLite should not need to interact with this directly.
+ */
+namespace impl {
+
+template <typename T>
+class WindowPool;
+
+// The observable handed out for a window; it can tell whether copies of it are still around
+template <typename T>
+class WindowObservable : public Observable<T> {
+public:
+    using Observable<T>::Observable;
+
+    bool isShared() const {
+        return this->sharedOnSubscribe.use_count() > 1;
+    }
+};
+
+// A lightweight subject for the windows of the window operators.
+//
+// Unlike `Subject`, a window is meant to be reused: once it is closed and every copy of its
+// observable is gone, nobody can observe it anymore, and `WindowPool` reopens it for a later
+// window. Its observable is built once, and the vector of subscribers keeps its storage, so a
+// reused window allocates nothing but the subscriptions of its consumers.
+template <typename T>
+class WindowSubject {
+public:
+    // Scratch space for the operator that owns the window
+    std::size_t count = 0;
+    Scheduler::TimePoint closesAt;
+    std::optional<Timer> closeTimer;
+
+    const Observable<T>& observable() const {
+        return handle;
+    }
+
+    void next(const T& value) {
+        std::unique_lock lock(mutex);
+        broadcasting++;
+
+        // Indexed, as subscribers may subscribe to the window from `next`
+        for (std::size_t i = 0; i < subscribers.size(); i++) {
+            subscribers[i]->next(value);
+        }
+
+        broadcasting--;
+    }
+
+    void error(const std::exception_ptr& err) {
+        close(err);
+    }
+
+    void complete() {
+        close(nullptr);
+    }
+
+private:
+    std::recursive_mutex mutex;
+    std::vector<std::shared_ptr<const Subscriber<T>>> subscribers;
+    int broadcasting = 0;
+    bool closed = false;
+    std::exception_ptr closeError;
+    WindowObservable<T> handle;
+
+    WindowSubject() : handle([](const Subscriber<T>&) {}) {}
+
+    static std::shared_ptr<WindowSubject> create() {
+        std::shared_ptr<WindowSubject> window(new WindowSubject());
+        std::weak_ptr<WindowSubject> weakWindow = window;
+
+        window->handle = WindowObservable<T>([weakWindow](const Subscriber<T>& subscriber) -> TeardownLogic {
+            auto window = weakWindow.lock();
+            if (!window) {
+                subscriber.complete();
+                return []() {};
+            }
+
+            std::unique_lock lock(window->mutex);
+            if (window->closed) {
+                if (window->closeError) {
+                    subscriber.error(window->closeError);
+                } else {
+                    subscriber.complete();
+                }
+                return []() {};
+            }
+
+            window->subscribers.push_back(subscriber.shared_from_this());
+
+            // The subscriber is freed once the window closes, and a later subscriber may take its
+            // address, so the teardown identifies it by its ownership rather than by pointer
+            return [weakWindow, target = std::weak_ptr(window->subscribers.back())]() {
+                if (auto window = weakWindow.lock()) {
+                    window->remove(target);
+                }
+            };
+        });
+
+        return window;
+    }
+
+    void close(const std::exception_ptr& err) {
+        std::unique_lock lock(mutex);
+        if (closed) {
+            return;
+        }
+
+        closed = true;
+        closeError = err;
+        broadcasting++;
+
+        for (std::size_t i = 0; i < subscribers.size(); i++) {
+            if (err) {
+                subscribers[i]->error(err);
+            } else {
+                subscribers[i]->complete();
+            }
+        }
+
+        broadcasting--;
+        subscribers.clear();
+    }
+
+    void remove(const std::weak_ptr<const Subscriber<T>>& subscriber) {
+        std::unique_lock lock(mutex);
+
+        // Unsubscribed subscribers ignore values; those removed mid-broadcast go once it closes
+        if (broadcasting == 0) {
+            std::erase_if(subscribers, [&subscriber](const auto& current) {
+                return !current.owner_before(subscriber) && !subscriber.owner_before(current);
+            });
+        }
+    }
+
+    bool isReusable() {
+        std::unique_lock lock(mutex);
+        return closed && !handle.isShared();
+    }
+
+    void reopen() {
+        std::unique_lock lock(mutex);
+        closed = false;
+        closeError = nullptr;
+        count = 0;
+    }
+
+    friend class WindowPool<T>;
+};
+
+// Hands out windows, reusing closed windows that can no longer be observed
+template <typename T>
+class WindowPool {
+public:
+    static constexpr std::size_t DefaultMaxPooled = 16;
+
+    explicit WindowPool(std::size_t maxPooled = DefaultMaxPooled) : maxPooled(maxPooled) {
+        closed.reserve(maxPooled);
+    }
+
+    std::shared_ptr<WindowSubject<T>> acquire() {
+        for (std::size_t i = 0; i < closed.size(); i++) {
+            if (closed[i]->isReusable()) {
+                std::shared_ptr<WindowSubject<T>> window = std::move(closed[i]);
+                closed[i] = std::move(closed.back());
+                closed.pop_back();
+
+                window->reopen();
+                return window;
+            }
+        }
+
+        return WindowSubject<T>::create();
+    }
+
+    // Takes back a closed window; it is reused once its observable is no longer referenced
+    void release(std::shared_ptr<WindowSubject<T>> window) {
+        if (closed.size() == maxPooled) {
+            // Make room by dropping a window that is still referenced, if there is one
+            auto referenced = std::find_if(closed.begin(), closed.end(), [](const auto& window) { return !window->isReusable(); });
+            if (referenced == closed.end()) {
+                return;
+            }
+
+            *referenced = std::move(window);
+            return;
+        }
+
+        closed.push_back(std::move(window));
+    }
+
+private:
+    const std::size_t maxPooled;
+    std::vector<std::shared_ptr<WindowSubject<T>>> closed;
+};
+
+} // namespace impl
+
+} // namespace RxLite
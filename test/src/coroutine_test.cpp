@@ -0,0 +1,166 @@
+#include <numeric>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "RxLite.hpp"
+
+using namespace std::chrono_literals;
+
+TEST(CoroutineTestsuite, AsyncGeneratorTest) {
+    RxLite::Observable<int> observable = RxLite::Observable<int>::create([]() -> RxLite::AsyncGenerator<int> {
+        for (int i = 1; i <= 5; i++) {
+            co_yield i;
+        }
+    });
+
+    std::vector<int> results;
+    bool hasCompleted = false;
+
+    RxLite::Observer<int> observer(
+        [&results](int value) { results.push_back(value); },
+        [](const std::exception_ptr&) {},
+        [&hasCompleted]() { hasCompleted = true; }
+    );
+
+    RxLite::Subscription subscription = observable.subscribe(observer);
+    ASSERT_EQ(results, (std::vector<int>{1, 2, 3, 4, 5}));
+    ASSERT_TRUE(hasCompleted);
+
+    // Each subscription runs a fresh coroutine
+    results.clear();
+    observable.subscribe(observer);
+    ASSERT_EQ(results, (std::vector<int>{1, 2, 3, 4, 5}));
+}
+
+TEST(CoroutineTestsuite, AsyncGeneratorErrorTest) {
+    RxLite::Observable<int> observable = RxLite::Observable<int>::create([]() -> RxLite::AsyncGenerator<int> {
+        co_yield 1;
+        throw std::runtime_error("broken");
+    });
+
+    std::vector<int> results;
+    bool hasFailed = false;
+
+    RxLite::Subscription subscription = observable.subscribe(RxLite::Observer<int>(
+        [&results](int value) { results.push_back(value); },
+        [&hasFailed](const std::exception_ptr&) { hasFailed = true; }
+    ));
+
+    ASSERT_EQ(results, (std::vector<int>{1}));
+    ASSERT_TRUE(hasFailed);
+}
+
+TEST(CoroutineTestsuite, AwaitTest) {
+    RxLite::Subject<int> subject;
+    RxLite::Observable<int> sequence = RxLite::Observable<int>::from({ 1, 2, 3 });
+    RxLite::Observable<int> none = RxLite::Observable<int>::from({});
+
+    // Waits for a value and a whole sequence from other observables, emitting in between
+    RxLite::Observable<int> observable = RxLite::Observable<int>::create([subject, sequence, none]() -> RxLite::AsyncGenerator<int> {
+        int first = co_await subject.first();
+        co_yield first;
+
+        std::vector<int> values = co_await sequence.toVector();
+        co_yield std::accumulate(values.begin(), values.end(), first);
+
+        bool empty = false;
+        try {
+            co_await none.first();
+        } catch (const std::out_of_range&) {
+            empty = true;
+        }
+
+        if (empty) {
+            co_yield -1;
+        }
+    });
+
+    std::vector<int> results;
+    bool hasCompleted = false;
+
+    RxLite::Subscription subscription = observable.subscribe(RxLite::Observer<int>(
+        [&results](int value) { results.push_back(value); },
+        [](const std::exception_ptr&) {},
+        [&hasCompleted]() { hasCompleted = true; }
+    ));
+
+    ASSERT_TRUE(results.empty());
+
+    std::thread([subject]() { subject.next(10); }).join();
+    ASSERT_EQ(results, (std::vector<int>{10, 16, -1}));
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(CoroutineTestsuite, UnsubscribeTest) {
+    RxLite::Subject<int> subject;
+    auto alive = std::make_shared<int>(0);
+    int produced = 0;
+
+    RxLite::Observable<int> observable = RxLite::Observable<int>::create([subject, alive, &produced]() -> RxLite::AsyncGenerator<int> {
+        auto guard = alive;
+        while (true) {
+            co_yield co_await subject.first();
+            produced++;
+        }
+    });
+
+    std::vector<int> results;
+    RxLite::Subscription subscription = observable.subscribe([&results](int value) { results.push_back(value); });
+
+    subject.next(1);
+    subject.next(2);
+    ASSERT_EQ(results, (std::vector<int>{1, 2}));
+    ASSERT_EQ(alive.use_count(), 3);
+
+    // Unsubscribing while suspended destroys the coroutine frame
+    subscription.unsubscribe();
+    ASSERT_EQ(alive.use_count(), 2);
+
+    subject.next(3);
+    ASSERT_EQ(results, (std::vector<int>{1, 2}));
+    ASSERT_EQ(produced, 2);
+}
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    int* allocations;
+
+    explicit CountingAllocator(int* allocations) : allocations(allocations) {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : allocations(other.allocations) {}
+
+    T* allocate(std::size_t n) {
+        (*allocations)++;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        std::allocator<T>().deallocate(p, n);
+    }
+};
+
+RxLite::AsyncGenerator<int> countTo(std::allocator_arg_t, CountingAllocator<int>, int n) {
+    for (int i = 1; i <= n; i++) {
+        co_yield i;
+    }
+}
+
+TEST(CoroutineTestsuite, FrameAllocatorTest) {
+    int allocations = 0;
+    CountingAllocator<int> allocator(&allocations);
+
+    RxLite::Observable<int> observable = RxLite::Observable<int>::create([allocator]() {
+        return countTo(std::allocator_arg, allocator, 3);
+    });
+
+    int sum = 0;
+    observable.subscribe([&sum](int value) { sum += value; });
+    observable.subscribe([&sum](int value) { sum += value; });
+
+    ASSERT_EQ(sum, 12);
+    ASSERT_EQ(allocations, 2);
+}
@@ -0,0 +1,333 @@
+#include <condition_variable>
+#include <cstdlib>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "RxLite.hpp"
+
+using namespace std::chrono_literals;
+
+static std::atomic<int> allocations = 0;
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// A minimal sender/receiver execution context: operations queue themselves intrusively
+// and run on whichever thread calls `runUntil()`
+class RunLoop {
+    struct Task {
+        Task* next = nullptr;
+        virtual void execute() = 0;
+    };
+
+public:
+    template <typename Receiver>
+    struct Operation : Task {
+        RunLoop* loop;
+        Receiver receiver;
+
+        Operation(RunLoop* loop, Receiver receiver) : loop(loop), receiver(std::move(receiver)) {}
+
+        void start() & noexcept {
+            loop->push(this);
+        }
+
+        void execute() override {
+            std::move(receiver).set_value();
+        }
+    };
+
+    struct Sender {
+        RunLoop* loop;
+
+        template <typename Receiver>
+        Operation<Receiver> connect(Receiver receiver) const {
+            return Operation<Receiver>(loop, std::move(receiver));
+        }
+    };
+
+    struct Scheduler {
+        RunLoop* loop;
+
+        Sender schedule() const {
+            return Sender{loop};
+        }
+
+        bool operator==(const Scheduler&) const = default;
+    };
+
+    Scheduler getScheduler() {
+        return Scheduler{this};
+    }
+
+    template <typename Predicate>
+    bool runUntil(Predicate&& predicate, std::chrono::milliseconds timeout = 5000ms) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock lock(mutex);
+
+        while (!predicate()) {
+            if (!head) {
+                if (ready.wait_until(lock, deadline) == std::cv_status::timeout) {
+                    return predicate();
+                }
+                continue;
+            }
+
+            Task* task = std::exchange(head, head->next);
+            if (!head) {
+                tail = nullptr;
+            }
+
+            executed++;
+            lock.unlock();
+            task->execute();
+            lock.lock();
+        }
+
+        return true;
+    }
+
+    int executed = 0;
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    Task* head = nullptr;
+    Task* tail = nullptr;
+
+    void push(Task* task) {
+        std::unique_lock lock(mutex);
+        task->next = nullptr;
+        (tail ? tail->next : head) = task;
+        tail = task;
+        ready.notify_one();
+    }
+};
+
+// Completes every operation right away, on the thread that starts it
+struct InlineScheduler {
+    template <typename Receiver>
+    struct Operation {
+        Receiver receiver;
+
+        void start() & noexcept {
+            std::move(receiver).set_value();
+        }
+    };
+
+    struct Sender {
+        template <typename Receiver>
+        Operation<Receiver> connect(Receiver receiver) const {
+            return Operation<Receiver>{std::move(receiver)};
+        }
+    };
+
+    Sender schedule() const {
+        return Sender{};
+    }
+
+    bool operator==(const InlineScheduler&) const = default;
+};
+
+template <typename T>
+struct ValueReceiver {
+    std::optional<T>* value;
+    std::exception_ptr* error;
+
+    template <typename... Args>
+    void set_value(Args&&... args) && noexcept {
+        value->emplace(std::forward<Args>(args)...);
+    }
+
+    void set_error(std::exception_ptr err) && noexcept {
+        *error = err;
+    }
+
+    void set_stopped() && noexcept {}
+};
+
+struct Empty {};
+
+TEST(ExecutionTestsuite, ScheduleSenderTest) {
+    RxLite::VirtualTimeScheduler scheduler;
+    std::optional<Empty> value;
+    std::exception_ptr error;
+
+    auto warmup = scheduler.schedule().connect(ValueReceiver<Empty>{&value, &error});
+    warmup.start();
+    scheduler.flush();
+    ASSERT_TRUE(value);
+
+    // Starting and completing the operation does not allocate
+    value.reset();
+    auto operation = scheduler.schedule().connect(ValueReceiver<Empty>{&value, &error});
+
+    int before = allocations;
+    operation.start();
+    ASSERT_FALSE(value);
+    scheduler.flush();
+    ASSERT_EQ(allocations, before);
+    ASSERT_TRUE(value);
+}
+
+TEST(ExecutionTestsuite, FirstValueFromTest) {
+    RxLite::Subject<int> subject;
+    std::optional<int> value;
+    std::exception_ptr error;
+
+    auto operation = RxLite::firstValueFrom<int>(subject).connect(ValueReceiver<int>{&value, &error});
+    operation.start();
+    ASSERT_FALSE(value);
+
+    subject.next(5);
+    subject.next(6);
+    ASSERT_EQ(value, 5);
+
+    // Synchronous sources complete the operation within `start()`
+    std::optional<int> first;
+    auto synchronous = RxLite::firstValueFrom(RxLite::Observable<int>::from({ 1, 2, 3 })).connect(ValueReceiver<int>{&first, &error});
+    synchronous.start();
+    ASSERT_EQ(first, 1);
+    ASSERT_FALSE(error);
+}
+
+TEST(ExecutionTestsuite, LastValueFromTest) {
+    RxLite::Subject<int> subject;
+    std::optional<int> value;
+    std::exception_ptr error;
+
+    auto operation = RxLite::lastValueFrom<int>(subject).connect(ValueReceiver<int>{&value, &error});
+    operation.start();
+
+    subject.next(1);
+    subject.next(2);
+    ASSERT_FALSE(value);
+
+    subject.complete();
+    ASSERT_EQ(value, 2);
+
+    std::optional<int> none;
+    auto empty = RxLite::lastValueFrom(RxLite::Observable<int>::from({})).connect(ValueReceiver<int>{&none, &error});
+    empty.start();
+    ASSERT_FALSE(none);
+    ASSERT_THROW(std::rethrow_exception(error), std::out_of_range);
+}
+
+TEST(ExecutionTestsuite, FromSenderTest) {
+    auto sender = RxLite::lastValueFrom(RxLite::Observable<int>::from({ 1, 2, 3 }));
+    RxLite::Observable<int> observable = RxLite::fromSender<int>(sender);
+
+    std::vector<int> results;
+    bool hasCompleted = false;
+
+    // Each subscription starts its own operation
+    for (int i = 0; i < 2; i++) {
+        RxLite::Subscription subscription = observable.subscribe(RxLite::Observer<int>(
+            [&results](int value) { results.push_back(value); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+    }
+
+    ASSERT_EQ(results, (std::vector<int>{3, 3}));
+    ASSERT_TRUE(hasCompleted);
+
+    bool hasFailed = false;
+    RxLite::fromSender<int>(RxLite::firstValueFrom(RxLite::Observable<int>::from({}))).subscribe(RxLite::Observer<int>(
+        [](int) {},
+        [&hasFailed](const std::exception_ptr&) { hasFailed = true; }
+    ));
+    ASSERT_TRUE(hasFailed);
+
+    // A sender without a value only completes, on the context it runs on
+    RunLoop loop;
+    hasCompleted = false;
+    RxLite::Subscription subscription = RxLite::fromSender<int>(loop.getScheduler().schedule()).subscribe(RxLite::Observer<int>(
+        [&results](int value) { results.push_back(value); },
+        [](const std::exception_ptr&) {},
+        [&hasCompleted]() { hasCompleted = true; }
+    ));
+
+    ASSERT_FALSE(hasCompleted);
+    ASSERT_TRUE(loop.runUntil([&]() { return hasCompleted; }));
+    ASSERT_EQ(results.size(), 2);
+}
+
+TEST(ExecutionTestsuite, ExecutionSchedulerTest) {
+    RunLoop loop;
+    RxLite::ExecutionScheduler scheduler(loop.getScheduler());
+
+    std::mutex mutex;
+    std::vector<int> results;
+    auto record = [&](int value) {
+        std::unique_lock lock(mutex);
+        results.push_back(value);
+    };
+
+    scheduler.schedule([&]() { record(1); });
+    scheduler.schedule([&]() { record(2); });
+    scheduler.schedule([&]() {
+        record(3);
+        scheduler.schedule([&]() { record(4); });
+    });
+
+    // Everything that is due runs in a single operation of the wrapped scheduler
+    auto size = [&]() {
+        std::unique_lock lock(mutex);
+        return results.size();
+    };
+
+    ASSERT_TRUE(loop.runUntil([&]() { return size() == 4; }));
+    ASSERT_EQ(loop.executed, 1);
+
+    // Delayed actions are handed over once they are due
+    auto start = std::chrono::steady_clock::now();
+    scheduler.scheduleAfter(20ms, [&]() { record(5); });
+    scheduler.scheduleAfter(10ms, [&]() { record(6); });
+
+    ASSERT_TRUE(loop.runUntil([&]() { return size() == 6; }));
+    ASSERT_GE(std::chrono::steady_clock::now() - start, 20ms);
+    ASSERT_EQ(results, (std::vector<int>{1, 2, 3, 4, 6, 5}));
+
+    // RxLite operators can run on the shared context
+    RxLite::Subscription subscription = RxLite::Observable<int>::from({ 7, 8 })
+        .pipe(RxLite::observeOn<int>(scheduler))
+        .subscribe([&](int value) { record(value); });
+
+    ASSERT_TRUE(loop.runUntil([&]() { return size() == 8; }));
+}
+
+TEST(ExecutionTestsuite, ExecutionSchedulerLastHandleTest) {
+    std::atomic<bool> ran = false;
+
+    {
+        RxLite::ExecutionScheduler scheduler{InlineScheduler{}};
+
+        // The delayed action drains inline on the timer thread, and holds the last handle
+        scheduler.scheduleAfter(20ms, [keep = RxLite::Scheduler(scheduler), &ran]() { ran = true; });
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!ran && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_TRUE(ran);
+
+    // Give the timer thread time to release the context, which must not join itself
+    std::this_thread::sleep_for(50ms);
+}
@@ -0,0 +1,310 @@
+#include <condition_variable>
+#include <numeric>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "RxLite.hpp"
+
+// Emits 0, 1, 2, ... as requested, counting the values handed to the subscriber
+static RxLite::Flowable<int> counter(std::shared_ptr<int> emitted, int count) {
+    return RxLite::Flowable<int>([emitted, count](const RxLite::FlowSubscriber<int>& subscriber) -> RxLite::TeardownLogic {
+        subscriber.onRequest([emitted, count, subscriber = subscriber.shared_from_this()](std::uint64_t) {
+            while (subscriber->requested() > 0 && !subscriber->isInactive()) {
+                subscriber->next((*emitted)++);
+
+                if (*emitted == count) {
+                    subscriber->complete();
+                }
+            }
+        });
+
+        return []() {};
+    });
+}
+
+TEST(FlowableTestsuite, RequestTest) {
+    std::vector<int> results;
+    bool hasCompleted = false;
+
+    RxLite::FlowSubscription subscription = RxLite::Flowable<int>::from({ 1, 2, 3, 4, 5 }).subscribe(RxLite::Observer<int>(
+        [&results](int value) { results.push_back(value); },
+        [](const std::exception_ptr&) {},
+        [&hasCompleted]() { hasCompleted = true; }
+    ), 0);
+
+    // Nothing is emitted without demand
+    ASSERT_TRUE(results.empty());
+
+    subscription.request(2);
+    ASSERT_EQ(results, (std::vector<int>{1, 2}));
+
+    subscription.request(0);
+    subscription.request(1);
+    ASSERT_EQ(results, (std::vector<int>{1, 2, 3}));
+    ASSERT_FALSE(hasCompleted);
+
+    subscription.request(10);
+    ASSERT_EQ(results, (std::vector<int>{1, 2, 3, 4, 5}));
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(FlowableTestsuite, PrefetchTest) {
+    auto emitted = std::make_shared<int>(0);
+    std::vector<int> results;
+    bool hasCompleted = false;
+
+    // Demand is replenished in batches of three quarters of the prefetch
+    RxLite::FlowSubscription subscription = counter(emitted, 1000).subscribe(RxLite::Observer<int>(
+        [&results](int value) { results.push_back(value); },
+        [](const std::exception_ptr&) {},
+        [&hasCompleted]() { hasCompleted = true; }
+    ), 8);
+
+    std::vector<int> expected(1000);
+    std::iota(expected.begin(), expected.end(), 0);
+    ASSERT_EQ(results, expected);
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(FlowableTestsuite, MissingBackpressureTest) {
+    RxLite::Flowable<int> flowable([](const RxLite::FlowSubscriber<int>& subscriber) -> RxLite::TeardownLogic {
+        subscriber.onRequest([subscriber = subscriber.shared_from_this()](std::uint64_t n) {
+            // Ignores the demand
+            for (std::uint64_t i = 0; i <= n; i++) {
+                subscriber->next(static_cast<int>(i));
+            }
+        });
+
+        return []() {};
+    });
+
+    int received = 0;
+    std::exception_ptr error;
+    RxLite::FlowSubscription subscription = flowable.subscribe(RxLite::Observer<int>(
+        [&received](int) { received++; },
+        [&error](const std::exception_ptr& err) { error = err; }
+    ), 0);
+
+    subscription.request(3);
+    ASSERT_EQ(received, 3);
+    ASSERT_THROW(std::rethrow_exception(error), RxLite::MissingBackpressure);
+}
+
+TEST(FlowableTestsuite, MapFilterTest) {
+    auto emitted = std::make_shared<int>(0);
+    std::vector<int> results;
+
+    RxLite::FlowSubscription subscription = counter(emitted, 100)
+        .pipe(
+            RxLite::flowable::filter<int>([](int value) { return value % 2 == 0; }),
+            RxLite::flowable::map<int>([](int value) { return value * 10; })
+        )
+        .subscribe(RxLite::Observer<int>([&results](int value) { results.push_back(value); }), 0);
+
+    ASSERT_EQ(*emitted, 0);
+
+    // Values dropped by the filter are requested again
+    subscription.request(3);
+    ASSERT_EQ(results, (std::vector<int>{0, 20, 40}));
+    ASSERT_LE(*emitted, 6);
+
+    subscription.request(2);
+    ASSERT_EQ(results, (std::vector<int>{0, 20, 40, 60, 80}));
+    ASSERT_LE(*emitted, 10);
+
+    subscription.unsubscribe();
+    subscription.request(10);
+    ASSERT_EQ(results.size(), 5);
+}
+
+TEST(FlowableTestsuite, ObserveOnTest) {
+    RxLite::VirtualTimeScheduler scheduler;
+    auto emitted = std::make_shared<int>(0);
+    std::vector<int> results;
+    bool hasCompleted = false;
+
+    RxLite::FlowSubscription subscription = counter(emitted, 100)
+        .pipe(RxLite::flowable::observeOn<int>(scheduler, 8))
+        .subscribe(RxLite::Observer<int>(
+            [&results](int value) { results.push_back(value); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ), 0);
+
+    // The queue is filled up front, but never beyond its capacity
+    ASSERT_EQ(*emitted, 8);
+    scheduler.flush();
+    ASSERT_TRUE(results.empty());
+
+    // A slow consumer keeps the producer at most one queue ahead
+    for (int i = 0; i < 20; i++) {
+        subscription.request(1);
+        scheduler.flush();
+        ASSERT_EQ(results.size(), i + 1);
+        ASSERT_LE(*emitted - static_cast<int>(results.size()), 8);
+    }
+
+    subscription.request(RxLite::FlowSubscription::Unbounded);
+    scheduler.flush();
+    ASSERT_EQ(results.size(), 100);
+    ASSERT_EQ(results.back(), 99);
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(FlowableTestsuite, ToObservableTest) {
+    std::vector<int> results;
+    bool hasCompleted = false;
+
+    RxLite::Subscription subscription = RxLite::Flowable<int>::from({ 1, 2, 3 })
+        .pipe(RxLite::flowable::map<int>([](int value) { return value + 1; }))
+        .toObservable()
+        .subscribe(RxLite::Observer<int>(
+            [&results](int value) { results.push_back(value); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+
+    ASSERT_EQ(results, (std::vector<int>{2, 3, 4}));
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(FlowableTestsuite, OnBackpressureBufferTest) {
+    RxLite::Subject<int> subject;
+    std::vector<int> results;
+    std::uint64_t dropped = 0;
+    bool hasCompleted = false;
+
+    RxLite::FlowSubscription subscription = subject
+        .pipe(RxLite::onBackpressureBuffer<int>(3, RxLite::OverflowPolicy::DropNewest, [&dropped](std::uint64_t count) { dropped = count; }))
+        .subscribe(RxLite::Observer<int>(
+            [&results](int value) { results.push_back(value); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ), 0);
+
+    for (int i = 0; i < 5; i++) {
+        subject.next(i);
+    }
+    ASSERT_TRUE(results.empty());
+    ASSERT_EQ(dropped, 2);
+
+    // Buffered values are delivered on request, completion once the buffer is empty
+    subscription.request(2);
+    ASSERT_EQ(results, (std::vector<int>{0, 1}));
+
+    subject.complete();
+    ASSERT_FALSE(hasCompleted);
+
+    subscription.request(1);
+    ASSERT_EQ(results, (std::vector<int>{0, 1, 2}));
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(FlowableTestsuite, OnBackpressureBufferOverflowTest) {
+    RxLite::Subject<int> subject;
+    std::vector<int> results;
+    std::exception_ptr error;
+
+    RxLite::FlowSubscription oldest = subject
+        .pipe(RxLite::onBackpressureBuffer<int>(2, RxLite::OverflowPolicy::DropOldest))
+        .subscribe(RxLite::Observer<int>([&results](int value) { results.push_back(value); }), 0);
+
+    RxLite::FlowSubscription failing = subject
+        .pipe(RxLite::onBackpressureBuffer<int>(2))
+        .subscribe(RxLite::Observer<int>(
+            [](int) {},
+            [&error](const std::exception_ptr& err) { error = err; }
+        ), 0);
+
+    for (int i = 0; i < 3; i++) {
+        subject.next(i);
+    }
+
+    // The error does not wait for demand
+    ASSERT_THROW(std::rethrow_exception(error), RxLite::MissingBackpressure);
+
+    oldest.request(5);
+    ASSERT_EQ(results, (std::vector<int>{1, 2}));
+}
+
+TEST(FlowableTestsuite, OnBackpressureDropLatestTest) {
+    RxLite::Subject<int> subject;
+    std::vector<int> dropResults;
+    std::vector<int> latestResults;
+    std::uint64_t dropped = 0;
+    std::uint64_t replaced = 0;
+
+    RxLite::FlowSubscription drop = subject
+        .pipe(RxLite::onBackpressureDrop<int>([&dropped](std::uint64_t count) { dropped = count; }))
+        .subscribe(RxLite::Observer<int>([&dropResults](int value) { dropResults.push_back(value); }), 0);
+
+    RxLite::FlowSubscription latest = subject
+        .pipe(RxLite::onBackpressureLatest<int>([&replaced](std::uint64_t count) { replaced = count; }))
+        .subscribe(RxLite::Observer<int>([&latestResults](int value) { latestResults.push_back(value); }), 0);
+
+    drop.request(1);
+    latest.request(1);
+    for (int i = 0; i < 5; i++) {
+        subject.next(i);
+    }
+
+    drop.request(1);
+    latest.request(1);
+    subject.next(5);
+
+    ASSERT_EQ(dropResults, (std::vector<int>{0, 5}));
+    ASSERT_EQ(dropped, 4);
+    ASSERT_EQ(latestResults, (std::vector<int>{0, 4}));
+    ASSERT_EQ(replaced, 3);
+}
+
+TEST(FlowableTestsuite, OnBackpressureMultipleProducersTest) {
+    RxLite::Subject<int> subject;
+    RxLite::EventLoopScheduler scheduler;
+
+    std::mutex mutex;
+    std::condition_variable completed;
+    std::uint64_t delivered = 0;
+    std::atomic<std::uint64_t> dropped = 0;
+    bool hasCompleted = false;
+
+    RxLite::FlowSubscription subscription = subject
+        .pipe(RxLite::onBackpressureBuffer<int>(64, RxLite::OverflowPolicy::DropNewest,
+                                                [&dropped](std::uint64_t) { dropped++; }, RxLite::Producers::Multiple))
+        .pipe(RxLite::flowable::observeOn<int>(scheduler, 16))
+        .subscribe(RxLite::Observer<int>(
+            [&](int) {
+                std::unique_lock lock(mutex);
+                delivered++;
+            },
+            [](const std::exception_ptr&) {},
+            [&]() {
+                std::unique_lock lock(mutex);
+                hasCompleted = true;
+                completed.notify_one();
+            }
+        ));
+
+    constexpr int Threads = 4;
+    constexpr int Values = 10000;
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < Threads; t++) {
+        producers.emplace_back([&subject]() {
+            for (int i = 0; i < Values; i++) {
+                subject.next(i);
+            }
+        });
+    }
+
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    subject.complete();
+
+    // Every value is either delivered or counted as dropped
+    std::unique_lock lock(mutex);
+    ASSERT_TRUE(completed.wait_for(lock, std::chrono::seconds(10), [&]() { return hasCompleted; }));
+    ASSERT_EQ(delivered + dropped, Threads * Values);
+}
@@ -1,9 +1,217 @@
 #include <gtest/gtest.h>
+#include <atomic>
 #include <cmath>
 #include <numeric>
+#include <stdexcept>
+#include <thread>
 
 #include "RxLite.hpp"
 
+// Feeds values into a subject at the given virtual times (in ms) and collects the results
+static std::vector<int> runTimed(RxLite::Operator<int, int> op, RxLite::VirtualTimeScheduler& scheduler,
+                                 const std::vector<std::pair<int, int>>& timedValues, int endTime) {
+    RxLite::Subject<int> subject;
+    std::vector<int> results;
+    RxLite::Subscription subscription = subject.pipe(op).subscribe([&results](int value) { results.push_back(value); });
+
+    auto start = scheduler.now();
+    for (const auto& [time, value] : timedValues) {
+        scheduler.advanceTo(start + std::chrono::milliseconds(time));
+        subject.next(value);
+    }
+
+    scheduler.advanceTo(start + std::chrono::milliseconds(endTime));
+    subject.complete();
+    return results;
+}
+
+TEST(OperatorTestsuite, AdaptiveBatchTest) {
+    RxLite::Subject<int> subject;
+    RxLite::VirtualTimeScheduler scheduler;
+
+    std::vector<std::vector<int>> results;
+    bool hasCompleted = false;
+
+    // The consumer is busy with the batch of 2 while 3 to 12 arrive
+    RxLite::Subscription subscription = subject.pipe(RxLite::adaptiveBatch<int>(std::chrono::milliseconds(10), 4, scheduler))
+        .subscribe(RxLite::Observer<std::vector<int>>(
+            [&](const std::vector<int>& batch) {
+                results.push_back(batch);
+                if (batch.front() == 2) {
+                    for (int i = 3; i <= 12; i++) {
+                        subject.next(i);
+                    }
+                }
+            },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+
+    // Nothing is emitted on the producer's thread; a value that finds the consumer idle goes out alone
+    subject.next(1);
+    ASSERT_TRUE(results.empty());
+    scheduler.flush();
+    ASSERT_EQ(results, (std::vector<std::vector<int>>{ { 1 } }));
+
+    // The backlog built up during a batch goes out in batches of up to the maximum size
+    subject.next(2);
+    scheduler.flush();
+    ASSERT_EQ(results, (std::vector<std::vector<int>>{ { 1 }, { 2 }, { 3, 4, 5, 6 }, { 7, 8, 9, 10 }, { 11, 12 } }));
+
+    // Completion waits for the pending values
+    subject.next(13);
+    subject.complete();
+    ASSERT_FALSE(hasCompleted);
+    scheduler.flush();
+    ASSERT_EQ(results.back(), (std::vector<int>{ 13 }));
+    ASSERT_TRUE(hasCompleted);
+
+    // An error discards the pending values and is not followed by completion
+    RxLite::Subject<int> failing;
+    int batches = 0;
+    int errors = 0;
+    int completions = 0;
+
+    RxLite::Subscription failingSubscription = failing.pipe(RxLite::adaptiveBatch<int>(std::chrono::milliseconds(10), 4, scheduler))
+        .subscribe(RxLite::Observer<std::vector<int>>(
+            [&batches](const std::vector<int>&) { batches++; },
+            [&errors](const std::exception_ptr&) { errors++; },
+            [&completions]() { completions++; }
+        ));
+
+    failing.next(1);
+    failing.error(std::make_exception_ptr(std::runtime_error("failed")));
+    failing.complete();
+    scheduler.flush();
+    ASSERT_EQ(batches, 0);
+    ASSERT_EQ(errors, 1);
+    ASSERT_EQ(completions, 0);
+
+    ASSERT_THROW(RxLite::adaptiveBatch<int>(std::chrono::milliseconds(10), 0, scheduler), std::invalid_argument);
+    ASSERT_THROW(RxLite::adaptiveBatch<int>(RxLite::Scheduler::Duration::zero(), 4, scheduler), std::invalid_argument);
+}
+
+TEST(OperatorTestsuite, AuditTimeTest) {
+    RxLite::VirtualTimeScheduler scheduler;
+
+    // Periods start at 0ms and 12ms
+    std::vector<int> results = runTimed(RxLite::auditTime<int>(std::chrono::milliseconds(10), scheduler), scheduler,
+                                        { { 0, 1 }, { 4, 2 }, { 8, 3 }, { 12, 4 }, { 15, 5 } }, 30);
+    ASSERT_EQ(results, (std::vector<int>{ 3, 5 }));
+
+    // The pending value is emitted on completion
+    results = runTimed(RxLite::auditTime<int>(std::chrono::milliseconds(10), scheduler), scheduler, { { 0, 1 } }, 5);
+    ASSERT_EQ(results, (std::vector<int>{ 1 }));
+}
+
+TEST(OperatorTestsuite, BufferCountTest) {
+    RxLite::Subject<int> subject;
+    RxLite::BatchPool<int> pool;
+
+    std::vector<std::vector<int>> consecutive;
+    std::vector<std::vector<int>> overlapping;
+    std::vector<std::vector<int>> sparse;
+    bool hasCompleted = false;
+
+    RxLite::Subscription consecutiveSubscription = subject.pipe(RxLite::bufferCount<int>(2, 0, pool))
+        .subscribe(RxLite::Observer<std::vector<int>>(
+            [&consecutive](const std::vector<int>& batch) { consecutive.push_back(batch); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+    RxLite::Subscription overlappingSubscription = subject.pipe(RxLite::bufferCount<int>(3, 1))
+        .subscribe([&overlapping](const std::vector<int>& batch) { overlapping.push_back(batch); });
+    RxLite::Subscription sparseSubscription = subject.pipe(RxLite::bufferCount<int>(1, 2))
+        .subscribe([&sparse](const std::vector<int>& batch) { sparse.push_back(batch); });
+
+    for (int i = 1; i <= 5; i++) {
+        subject.next(i);
+    }
+
+    ASSERT_EQ(consecutive, (std::vector<std::vector<int>>{ { 1, 2 }, { 3, 4 } }));
+    ASSERT_EQ(overlapping, (std::vector<std::vector<int>>{ { 1, 2, 3 }, { 2, 3, 4 }, { 3, 4, 5 } }));
+    ASSERT_EQ(sparse, (std::vector<std::vector<int>>{ { 1 }, { 3 }, { 5 } }));
+
+    // Partial batches are flushed on completion
+    subject.complete();
+    ASSERT_EQ(consecutive.back(), (std::vector<int>{ 5 }));
+    ASSERT_EQ(overlapping.size(), 5);
+    ASSERT_TRUE(hasCompleted);
+
+    // The storage of every emitted batch was handed back to the pool and reused
+    ASSERT_EQ(pool.size(), 1);
+
+    ASSERT_THROW(RxLite::bufferCount<int>(0), std::invalid_argument);
+}
+
+TEST(OperatorTestsuite, BufferTimeTest) {
+    RxLite::Subject<int> subject;
+    RxLite::VirtualTimeScheduler scheduler;
+
+    std::vector<std::vector<int>> results;
+    bool hasCompleted = false;
+
+    RxLite::Subscription subscription = subject.pipe(RxLite::bufferTime<int>(std::chrono::milliseconds(10), 3, scheduler))
+        .subscribe(RxLite::Observer<std::vector<int>>(
+            [&results](const std::vector<int>& batch) { results.push_back(batch); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+
+    subject.next(1);
+    subject.next(2);
+    scheduler.advanceBy(std::chrono::milliseconds(10));
+    ASSERT_EQ(results, (std::vector<std::vector<int>>{ { 1, 2 } }));
+
+    // Empty time spans emit nothing
+    scheduler.advanceBy(std::chrono::milliseconds(10));
+    ASSERT_EQ(results.size(), 1);
+
+    // A full batch is emitted right away and starts a new time span
+    scheduler.advanceBy(std::chrono::milliseconds(5));
+    for (int i = 3; i <= 6; i++) {
+        subject.next(i);
+    }
+    ASSERT_EQ(results.back(), (std::vector<int>{ 3, 4, 5 }));
+
+    scheduler.advanceBy(std::chrono::milliseconds(9));
+    ASSERT_EQ(results.size(), 2);
+    scheduler.advanceBy(std::chrono::milliseconds(1));
+    ASSERT_EQ(results.back(), (std::vector<int>{ 6 }));
+
+    subject.next(7);
+    subject.complete();
+    ASSERT_EQ(results.back(), (std::vector<int>{ 7 }));
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(OperatorTestsuite, BufferWhenTest) {
+    RxLite::Subject<int> subject;
+    RxLite::Subject<bool> notifier;
+
+    std::vector<std::vector<int>> results;
+    bool hasCompleted = false;
+
+    RxLite::Subscription subscription = subject.pipe(RxLite::bufferWhen<int>(RxLite::Observable<bool>(notifier)))
+        .subscribe(RxLite::Observer<std::vector<int>>(
+            [&results](const std::vector<int>& batch) { results.push_back(batch); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+
+    subject.next(1);
+    subject.next(2);
+    notifier.next(true);
+    notifier.next(true);
+    subject.next(3);
+    notifier.next(true);
+    subject.next(4);
+    subject.complete();
+
+    ASSERT_EQ(results, (std::vector<std::vector<int>>{ { 1, 2 }, { 3 }, { 4 } }));
+    ASSERT_TRUE(hasCompleted);
+}
+
 TEST(OperatorTestsuite, CombineLatestTest) {
     RxLite::Subject<int> sourceSubject;
     RxLite::Subject<int> latestSubject;
@@ -45,6 +253,157 @@ TEST(OperatorTestsuite, CombineLatestTest) {
     ASSERT_EQ(hasCompleted, true);
 }
 
+TEST(OperatorTestsuite, CombineLatestNTest) {
+    std::vector<RxLite::Subject<int>> subjects(3);
+    std::vector<RxLite::Observable<int>> observables(subjects.begin(), subjects.end());
+
+    std::vector<std::vector<int>> results;
+    bool hasCompleted = false;
+
+    RxLite::Subscription subscription = RxLite::combineLatestN<int>(observables)
+        .subscribe(RxLite::Observer<std::span<const int>>(
+            [&results](std::span<const int> values) { results.emplace_back(values.begin(), values.end()); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+
+    // Nothing is emitted until every source has a value
+    subjects[0].next(1);
+    subjects[2].next(3);
+    subjects[0].next(10);
+    ASSERT_TRUE(results.empty());
+
+    subjects[1].next(2);
+    subjects[2].next(30);
+    ASSERT_EQ(results, (std::vector<std::vector<int>>{ { 10, 2, 3 }, { 10, 2, 30 } }));
+
+    subjects[0].complete();
+    subjects[1].complete();
+    ASSERT_FALSE(hasCompleted);
+    subjects[2].complete();
+    ASSERT_TRUE(hasCompleted);
+
+    // A source that completes without a value completes the result right away
+    std::vector<RxLite::Subject<int>> others(2);
+    bool otherCompleted = false;
+    RxLite::Subscription otherSubscription = RxLite::combineLatestN<int>({ others[0], others[1] })
+        .subscribe(RxLite::Observer<std::span<const int>>(
+            [](std::span<const int>) {},
+            [](const std::exception_ptr&) {},
+            [&otherCompleted]() { otherCompleted = true; }
+        ));
+
+    others[0].next(1);
+    others[1].complete();
+    ASSERT_TRUE(otherCompleted);
+}
+
+TEST(OperatorTestsuite, ConcatMapTest) {
+    std::vector<int> results;
+    bool hasCompleted = false;
+
+    // Inner observables that complete right away are chained without recursion
+    std::vector<int> input(10000);
+    std::iota(input.begin(), input.end(), 0);
+
+    RxLite::Subscription subscription = RxLite::Observable<int>::from(input)
+        .pipe(RxLite::concatMap<int>([](int value) { return RxLite::Observable<int>::from({ value, -value }); }))
+        .subscribe(RxLite::Observer<int>(
+            [&results](int value) { results.push_back(value); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+
+    ASSERT_EQ(results.size(), 20000);
+    ASSERT_EQ(results[2], 1);
+    ASSERT_EQ(results[3], -1);
+    ASSERT_TRUE(hasCompleted);
+
+    // Later values wait for the current inner observable to complete
+    RxLite::Subject<int> subject;
+    std::vector<RxLite::Subject<int>> inners(3);
+    results.clear();
+
+    RxLite::Subscription queuedSubscription = subject
+        .pipe(RxLite::concatMap<int>([&inners](int index) { return RxLite::Observable<int>(inners[index]); }))
+        .subscribe([&results](int value) { results.push_back(value); });
+
+    subject.next(0);
+    subject.next(1);
+    inners[1].next(100);
+    inners[0].next(1);
+    inners[0].complete();
+    inners[1].next(2);
+
+    ASSERT_EQ(results, (std::vector<int>{ 1, 2 }));
+}
+
+TEST(OperatorTestsuite, ConflateByKeyTest) {
+    RxLite::Subject<std::pair<std::string, int>> quotes;
+    RxLite::VirtualTimeScheduler scheduler;
+
+    std::vector<std::pair<std::string, int>> results;
+    bool hasCompleted = false;
+
+    RxLite::Subscription subscription = quotes.pipe(
+        RxLite::conflateByKey<std::pair<std::string, int>>([](const auto& quote) { return quote.first; }, scheduler)
+    ).subscribe(RxLite::Observer<std::pair<std::string, int>>(
+        [&](const std::pair<std::string, int>& quote) {
+            results.push_back(quote);
+
+            // Quotes arriving while the consumer is busy are conflated as well
+            if (quote == std::pair<std::string, int>("B", 2)) {
+                quotes.next({ "C", 1 });
+                quotes.next({ "C", 2 });
+            }
+        },
+        [](const std::exception_ptr&) {},
+        [&hasCompleted]() { hasCompleted = true; }
+    ));
+
+    quotes.next({ "A", 1 });
+    quotes.next({ "B", 1 });
+    quotes.next({ "A", 2 });
+    quotes.next({ "B", 2 });
+    ASSERT_TRUE(results.empty());
+
+    // Latest value per key, in the order the keys first arrived
+    scheduler.flush();
+    ASSERT_EQ(results, (std::vector<std::pair<std::string, int>>{ { "A", 2 }, { "B", 2 }, { "C", 2 } }));
+
+    quotes.next({ "A", 3 });
+    quotes.complete();
+    ASSERT_FALSE(hasCompleted);
+
+    scheduler.flush();
+    ASSERT_EQ(results.back(), (std::pair<std::string, int>("A", 3)));
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(OperatorTestsuite, DebounceTimeTest) {
+    RxLite::VirtualTimeScheduler scheduler;
+
+    // Bursts at 0-8ms and 30-32ms, a single value at 50ms that is pending on completion
+    std::vector<int> results = runTimed(RxLite::debounceTime<int>(std::chrono::milliseconds(10), scheduler), scheduler,
+                                        { { 0, 1 }, { 4, 2 }, { 8, 3 }, { 30, 4 }, { 32, 5 }, { 50, 6 } }, 55);
+    ASSERT_EQ(results, (std::vector<int>{ 3, 5, 6 }));
+
+    // Every value moves the same timer instead of queueing another one
+    RxLite::Subject<int> subject;
+    std::vector<int> debounced;
+    RxLite::Subscription subscription = subject.pipe(RxLite::debounceTime<int>(std::chrono::milliseconds(10), scheduler))
+        .subscribe([&debounced](int value) { debounced.push_back(value); });
+
+    for (int i = 0; i < 1000; i++) {
+        subject.next(i);
+    }
+    ASSERT_EQ(scheduler.pendingCount(), 1);
+
+    scheduler.flush();
+    ASSERT_EQ(debounced, (std::vector<int>{ 999 }));
+    ASSERT_EQ(scheduler.pendingCount(), 0);
+}
+
 TEST(OperatorTestsuite, DistinctTest) {
     RxLite::Subject<int> sourceSubject;
 
@@ -84,6 +443,122 @@ TEST(OperatorTestsuite, DistinctTest) {
     ASSERT_EQ(hasCompleted, false);
     sourceSubject.complete();
     ASSERT_EQ(hasCompleted, true);
+
+    // The set behind distinct stores nothing besides each key
+    struct Unit {};
+    static_assert(sizeof(RxLite::impl::FlatHashMap<int, Unit>::value_type) == sizeof(int));
+}
+
+TEST(OperatorTestsuite, DistinctKeySelectorTest) {
+    RxLite::Subject<std::pair<int, int>> subject;
+    std::vector<int> results;
+
+    // Keys are compared by their remainder modulo 10, using a custom hash and equality
+    struct ModuloHash {
+        std::size_t operator()(int key) const { return std::hash<int>()(key % 10); }
+    };
+    struct ModuloEqual {
+        bool operator()(int a, int b) const { return a % 10 == b % 10; }
+    };
+
+    RxLite::Subscription subscription = subject
+        .pipe(RxLite::distinct<std::pair<int, int>>([](const std::pair<int, int>& value) { return value.first; }, ModuloHash(), ModuloEqual()))
+        .subscribe([&results](const std::pair<int, int>& value) { results.push_back(value.second); });
+
+    subject.next({ 1, 100 });
+    subject.next({ 2, 200 });
+    subject.next({ 11, 300 });
+    subject.next({ 3, 400 });
+    subject.next({ 22, 500 });
+
+    ASSERT_EQ(results, (std::vector<int>{ 100, 200, 400 }));
+}
+
+TEST(OperatorTestsuite, DistinctApproxTest) {
+    RxLite::Subject<int> subject;
+    RxLite::DistinctApproxStats stats;
+    int emitted = 0;
+
+    RxLite::Subscription subscription = subject
+        .pipe(RxLite::distinctApprox<int>(10000, 0.01, stats))
+        .subscribe([&emitted](int) { emitted++; });
+
+    // Duplicates are always suppressed, new values only rarely
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 10000; i++) {
+            subject.next(i);
+        }
+    }
+
+    ASSERT_GE(emitted, 9900);
+    ASSERT_LE(emitted, 10000);
+    ASSERT_EQ(stats.emitted(), emitted);
+    ASSERT_EQ(stats.suppressed(), 30000 - emitted);
+    ASSERT_GT(stats.fill(), 0.1);
+    ASSERT_LT(stats.fill(), 0.9);
+    ASSERT_LT(stats.falsePositiveRate(), 0.02);
+
+    // Once the subject drops the old subscriber, the fill only covers the new filter
+    subscription.unsubscribe();
+    subscription = subject
+        .pipe(RxLite::distinctApprox<int>(10000, 0.01, stats))
+        .subscribe([&emitted](int) { emitted++; });
+    subject.next(0);
+    ASSERT_EQ(stats.emitted(), emitted);
+    ASSERT_GT(stats.fill(), 0.0);
+    ASSERT_LT(stats.fill(), 0.001);
+
+    ASSERT_THROW(RxLite::distinctApprox<int>(0, 0.01), std::invalid_argument);
+    ASSERT_THROW(RxLite::distinctApprox<int>(100, 1.0), std::invalid_argument);
+}
+
+TEST(OperatorTestsuite, DistinctCapacityTest) {
+    RxLite::Subject<int> subject;
+    std::vector<int> results;
+
+    RxLite::Subscription subscription = subject
+        .pipe(RxLite::distinct<int>([](int value) { return value; }, 2))
+        .subscribe([&results](int value) { results.push_back(value); });
+
+    // Seeing 1 again keeps it, so 3 evicts the least recently seen key, 2
+    for (int value : { 1, 2, 1, 3, 1, 2, 3 }) {
+        subject.next(value);
+    }
+
+    ASSERT_EQ(results, (std::vector<int>{ 1, 2, 3, 2, 3 }));
+
+    // Many distinct keys only ever keep the last two
+    results.clear();
+    for (int i = 0; i < 1000; i++) {
+        subject.next(i);
+        subject.next(i);
+    }
+    ASSERT_EQ(results.size(), 1000);
+}
+
+TEST(OperatorTestsuite, DistinctTimeToLiveTest) {
+    RxLite::Subject<int> subject;
+    RxLite::VirtualTimeScheduler scheduler;
+    std::vector<int> results;
+
+    RxLite::Subscription subscription = subject
+        .pipe(RxLite::distinct<int>([](int value) { return value; }, std::chrono::milliseconds(10), scheduler))
+        .subscribe([&results](int value) { results.push_back(value); });
+
+    subject.next(1);
+    subject.next(2);
+    scheduler.advanceBy(std::chrono::milliseconds(6));
+
+    // Seeing 2 again extends its time to live
+    subject.next(2);
+    scheduler.advanceBy(std::chrono::milliseconds(6));
+    subject.next(1);
+    subject.next(2);
+
+    scheduler.advanceBy(std::chrono::milliseconds(10));
+    subject.next(2);
+
+    ASSERT_EQ(results, (std::vector<int>{ 1, 2, 1, 2 }));
 }
 
 TEST(OperatorTestsuite, DistinctUntilChangedTest) {
@@ -127,6 +602,179 @@ TEST(OperatorTestsuite, DistinctUntilChangedTest) {
     ASSERT_EQ(hasCompleted, true);
 }
 
+TEST(OperatorTestsuite, DistinctUntilChangedKeyTest) {
+    struct Record {
+        int version;
+        std::string payload;
+    };
+
+    RxLite::Subject<Record> subject;
+    std::vector<std::string> byVersion;
+    std::vector<std::string> byPrefix;
+
+    // Only the version is kept and compared
+    RxLite::Subscription versionSubscription = subject
+        .pipe(RxLite::distinctUntilChanged<Record>([](const Record& record) { return record.version; }))
+        .subscribe([&byVersion](const Record& record) { byVersion.push_back(record.payload); });
+
+    RxLite::Subscription prefixSubscription = subject
+        .pipe(RxLite::distinctUntilChanged<Record>([](const Record& previous, const Record& current) {
+            return previous.payload.front() == current.payload.front();
+        }))
+        .subscribe([&byPrefix](const Record& record) { byPrefix.push_back(record.payload); });
+
+    subject.next({ 1, "a1" });
+    subject.next({ 1, "a2" });
+    subject.next({ 2, "b1" });
+    subject.next({ 2, "a3" });
+    subject.next({ 1, "a4" });
+
+    ASSERT_EQ(byVersion, (std::vector<std::string>{ "a1", "b1", "a4" }));
+    ASSERT_EQ(byPrefix, (std::vector<std::string>{ "a1", "b1", "a3" }));
+}
+
+TEST(OperatorTestsuite, ExhaustMapTest) {
+    RxLite::Subject<int> subject;
+    std::vector<RxLite::Subject<int>> inners(3);
+    std::vector<int> results;
+    int projected = 0;
+
+    RxLite::Subscription subscription = subject
+        .pipe(RxLite::exhaustMap<int>([&](int index) {
+            projected++;
+            return RxLite::Observable<int>(inners[index]);
+        }))
+        .subscribe([&results](int value) { results.push_back(value); });
+
+    // Values are ignored while an inner observable is active
+    subject.next(0);
+    subject.next(1);
+    inners[0].next(1);
+    inners[0].complete();
+
+    subject.next(2);
+    inners[1].next(100);
+    inners[2].next(3);
+
+    ASSERT_EQ(results, (std::vector<int>{ 1, 3 }));
+    ASSERT_EQ(projected, 2);
+}
+
+TEST(OperatorTestsuite, GroupByTest) {
+    RxLite::Subject<int> subject;
+    std::vector<RxLite::Subscription> groupSubscriptions;
+
+    std::vector<int> keys;
+    std::map<int, std::vector<int>> grouped;
+    int completedGroups = 0;
+
+    RxLite::Subscription subscription = subject.pipe(RxLite::groupBy<int>([](int value) { return value % 3; }))
+        .subscribe([&](const RxLite::GroupedObservable<int, int>& group) {
+            keys.push_back(group.key());
+            groupSubscriptions.push_back(group.subscribe(RxLite::Observer<int>(
+                [&grouped, key = group.key()](int value) { grouped[key].push_back(value); },
+                [](const std::exception_ptr&) {},
+                [&completedGroups]() { completedGroups++; }
+            )));
+        });
+
+    for (int i = 1; i <= 7; i++) {
+        subject.next(i);
+    }
+
+    ASSERT_EQ(keys, (std::vector<int>{ 1, 2, 0 }));
+    ASSERT_EQ(grouped, (std::map<int, std::vector<int>>{ { 0, { 3, 6 } }, { 1, { 1, 4, 7 } }, { 2, { 2, 5 } } }));
+
+    subject.complete();
+    ASSERT_EQ(completedGroups, 3);
+
+    // Idle groups complete and are reopened by their next value
+    RxLite::VirtualTimeScheduler scheduler;
+    RxLite::Subject<std::string> words;
+    std::vector<std::string> opened;
+    std::vector<std::string> expired;
+
+    RxLite::GroupByConfig config;
+    config.idleTimeout = std::chrono::milliseconds(10);
+    config.scheduler = scheduler;
+
+    RxLite::Subscription expiringSubscription = words
+        .pipe(RxLite::groupBy<std::string>([](const std::string& word) { return word.substr(0, 1); }, config))
+        .subscribe([&](const RxLite::GroupedObservable<std::string, std::string>& group) {
+            opened.push_back(group.key());
+            groupSubscriptions.push_back(group.subscribe(RxLite::Observer<std::string>(
+                [](const std::string&) {},
+                [](const std::exception_ptr&) {},
+                [&expired, key = group.key()]() { expired.push_back(key); }
+            )));
+        });
+
+    words.next("apple");
+    words.next("banana");
+    scheduler.advanceBy(std::chrono::milliseconds(6));
+    words.next("avocado");
+
+    scheduler.advanceBy(std::chrono::milliseconds(6));
+    ASSERT_EQ(expired, std::vector<std::string>{ "b" });
+
+    scheduler.advanceBy(std::chrono::milliseconds(6));
+    ASSERT_EQ(expired, (std::vector<std::string>{ "b", "a" }));
+
+    words.next("blueberry");
+    ASSERT_EQ(opened, (std::vector<std::string>{ "a", "b", "b" }));
+
+    ASSERT_THROW(RxLite::groupBy<int>([](int value) { return value; }, RxLite::GroupByConfig{ {}, std::chrono::milliseconds(10), std::nullopt }), std::invalid_argument);
+}
+
+TEST(OperatorTestsuite, GroupByWorkersTest) {
+    constexpr int Keys = 8;
+    constexpr int ValuesPerKey = 1000;
+
+    RxLite::GroupByConfig config;
+    for (int i = 0; i < 4; i++) {
+        config.workers.push_back(RxLite::EventLoopScheduler<>());
+    }
+
+    RxLite::Subject<int> subject;
+    std::vector<RxLite::Subscription> groupSubscriptions;
+
+    // Each key is only touched by the worker its group is pinned to
+    std::vector<std::vector<int>> received(Keys);
+    std::vector<std::thread::id> threads(Keys);
+    std::vector<char> sameThread(Keys, true);
+    std::atomic<int> completedGroups = 0;
+
+    RxLite::Subscription subscription = subject.pipe(RxLite::groupBy<int>([](int value) { return value % Keys; }, config))
+        .subscribe([&](const RxLite::GroupedObservable<int, int>& group) {
+            groupSubscriptions.push_back(group.subscribe(RxLite::Observer<int>(
+                [&, key = group.key()](int value) {
+                    if (received[key].empty()) {
+                        threads[key] = std::this_thread::get_id();
+                    }
+                    sameThread[key] = sameThread[key] && threads[key] == std::this_thread::get_id();
+                    received[key].push_back(value);
+                },
+                [](const std::exception_ptr&) {},
+                [&completedGroups]() { completedGroups++; }
+            )));
+        });
+
+    for (int i = 0; i < Keys * ValuesPerKey; i++) {
+        subject.next(i);
+    }
+    subject.complete();
+
+    while (completedGroups < Keys) {
+        std::this_thread::yield();
+    }
+
+    for (int key = 0; key < Keys; key++) {
+        ASSERT_EQ(received[key].size(), ValuesPerKey);
+        ASSERT_TRUE(std::is_sorted(received[key].begin(), received[key].end()));
+        ASSERT_TRUE(sameThread[key]);
+    }
+}
+
 TEST(OperatorTestsuite, MapTest) {
     RxLite::Subject<int> subject;
     RxLite::Observable<int> observable = subject.pipe(
@@ -173,6 +821,579 @@ TEST(OperatorTestsuite, MergeTest) {
     ASSERT_EQ(hasCompleted, hasCompleted);
 }
 
+TEST(OperatorTestsuite, MergeAllTest) {
+    std::vector<RxLite::Subject<int>> subjects(8);
+    std::vector<RxLite::Observable<int>> observables(subjects.begin(), subjects.end());
+
+    std::atomic<bool> inside = false;
+    bool overlapped = false;
+    std::int64_t sum = 0;
+    int completions = 0;
+
+    RxLite::Subscription subscription = RxLite::mergeAll<int>(observables)
+        .subscribe(RxLite::Observer<int>(
+            [&](int value) {
+                overlapped = overlapped || inside.exchange(true);
+                sum += value;
+                inside = false;
+            },
+            [](const std::exception_ptr&) {},
+            [&]() { completions++; }
+        ));
+
+    // Each source emits and completes on its own thread; deliveries never overlap
+    std::vector<std::thread> producers;
+    for (RxLite::Subject<int>& subject : subjects) {
+        producers.emplace_back([&subject]() {
+            for (int i = 1; i <= 10000; i++) {
+                subject.next(i);
+            }
+            subject.complete();
+        });
+    }
+
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+
+    ASSERT_FALSE(overlapped);
+    ASSERT_EQ(sum, 8 * (10000 * 10001 / 2));
+    ASSERT_EQ(completions, 1);
+
+    bool emptyCompleted = false;
+    RxLite::Subscription emptySubscription = RxLite::mergeAll<int>({})
+        .subscribe(RxLite::Observer<int>([](int) {}, [](const std::exception_ptr&) {}, [&emptyCompleted]() { emptyCompleted = true; }));
+    ASSERT_TRUE(emptyCompleted);
+}
+
+TEST(OperatorTestsuite, MergeMapTest) {
+    RxLite::Subject<int> subject;
+    std::vector<RxLite::Subject<int>> inners(4);
+    std::vector<int> results;
+    int projected = 0;
+    bool hasCompleted = false;
+
+    RxLite::Subscription subscription = subject
+        .pipe(RxLite::mergeMap<int>([&](int index) {
+            projected++;
+            return RxLite::Observable<int>(inners[index]);
+        }, 2))
+        .subscribe(RxLite::Observer<int>(
+            [&results](int value) { results.push_back(value); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+
+    // At most two inner observables are active, further values are queued
+    for (int i = 0; i < 4; i++) {
+        subject.next(i);
+    }
+    ASSERT_EQ(projected, 2);
+
+    inners[1].next(10);
+    inners[0].next(0);
+    ASSERT_EQ(results, (std::vector<int>{ 10, 0 }));
+
+    inners[0].complete();
+    ASSERT_EQ(projected, 3);
+    inners[2].next(20);
+    inners[1].complete();
+    inners[3].next(30);
+    ASSERT_EQ(results, (std::vector<int>{ 10, 0, 20, 30 }));
+
+    // Completion waits for every inner observable
+    subject.complete();
+    inners[2].complete();
+    ASSERT_FALSE(hasCompleted);
+    inners[3].complete();
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(OperatorTestsuite, MergeMapConcurrentTest) {
+    RxLite::Subject<int> subject;
+    RxLite::Subject<int> inner;
+    std::atomic<int> received = 0;
+    std::atomic<bool> hasCompleted = false;
+
+    RxLite::Subscription subscription = subject
+        .pipe(RxLite::mergeMap<int>([&inner](int) { return RxLite::Observable<int>(inner); }))
+        .subscribe(RxLite::Observer<int>(
+            [&received](int) { received++; },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+
+    // Subscribing to the inner subject races with its broadcasts, which must not deadlock
+    std::atomic<bool> stop = false;
+    std::thread producer([&]() {
+        while (!stop) {
+            inner.next(1);
+        }
+    });
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    for (int i = 0; i < 20000 && std::chrono::steady_clock::now() < deadline; i++) {
+        subject.next(i);
+    }
+
+    stop = true;
+    producer.join();
+
+    subject.complete();
+    ASSERT_FALSE(hasCompleted);
+    inner.complete();
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(OperatorTestsuite, MergeMapProjectThrowsTest) {
+    RxLite::Subject<int> subject;
+    std::vector<int> results;
+    bool hasFailed = false;
+
+    RxLite::Subscription subscription = subject
+        .pipe(RxLite::mergeMap<int>([](int value) {
+            if (value == 2) {
+                throw std::runtime_error("project failed");
+            }
+            return RxLite::Observable<int>::of(value);
+        }, 1))
+        .subscribe(RxLite::Observer<int>(
+            [&results](int value) { results.push_back(value); },
+            [&hasFailed](const std::exception_ptr&) { hasFailed = true; },
+            []() { FAIL(); }
+        ));
+
+    // The error of `project` fails the operator rather than leaving its slot taken
+    subject.next(1);
+    subject.next(2);
+    ASSERT_TRUE(hasFailed);
+
+    subject.next(3);
+    subject.complete();
+    ASSERT_EQ(results, (std::vector<int>{ 1 }));
+}
+
+TEST(OperatorTestsuite, ObserveOnTest) {
+    RxLite::TestScheduler scheduler;
+    std::map<char, int> values = {{'a', 1}, {'b', 2}};
+
+    auto recorded = scheduler.record(
+        scheduler.createColdObservable<int>("a-b|", values).pipe(
+            RxLite::observeOn<int>(scheduler)
+        )
+    );
+
+    scheduler.flush();
+    ASSERT_EQ(*recorded, scheduler.parseMarbles<int>("a-b|", values));
+
+    // An observer feeding its own source recurses through the trampoline instead of the stack
+    RxLite::Subject<int> subject;
+    int depth = 0;
+    int maxDepth = 0;
+    int last = 0;
+
+    RxLite::Subscription subscription = subject.pipe(
+        RxLite::observeOn<int>(RxLite::TrampolineScheduler())
+    ).subscribe([&](int i) {
+        depth++;
+        maxDepth = std::max(maxDepth, depth);
+        last = i;
+
+        if (i < 100000) {
+            subject.next(i + 1);
+        }
+
+        depth--;
+    });
+
+    subject.next(1);
+    ASSERT_EQ(last, 100000);
+    ASSERT_EQ(maxDepth, 1);
+}
+
+TEST(OperatorTestsuite, RateLimitTest) {
+    RxLite::VirtualTimeScheduler scheduler;
+    RxLite::Subject<int> subject;
+    RxLite::RateLimitStats stats;
+
+    // 100 values per second (one per 10ms) with a burst of 2
+    std::vector<std::pair<long, int>> delayed;
+    std::vector<int> dropped;
+    std::vector<std::vector<int>> batched;
+    auto start = scheduler.now();
+    auto elapsed = [&]() { return std::chrono::duration_cast<std::chrono::milliseconds>(scheduler.now() - start).count(); };
+
+    RxLite::Subscription delaySubscription = subject.pipe(RxLite::rateLimit<int>(100, 2, scheduler, stats))
+        .subscribe([&](int value) { delayed.emplace_back(elapsed(), value); });
+    RxLite::Subscription dropSubscription = subject.pipe(RxLite::rateLimit<int, RxLite::RateLimitPolicy::Drop>(100, 2, scheduler, stats))
+        .subscribe([&](int value) { dropped.push_back(value); });
+    RxLite::Subscription batchSubscription = subject.pipe(RxLite::rateLimit<int, RxLite::RateLimitPolicy::Batch>(100, 2, scheduler))
+        .subscribe([&](const std::vector<int>& batch) { batched.push_back(batch); });
+
+    for (int i = 1; i <= 5; i++) {
+        subject.next(i);
+    }
+    scheduler.advanceBy(std::chrono::milliseconds(100));
+
+    // The burst passes right away, the rest follows at the rate
+    ASSERT_EQ(delayed, (std::vector<std::pair<long, int>>{ { 0, 1 }, { 0, 2 }, { 10, 3 }, { 20, 4 }, { 30, 5 } }));
+    ASSERT_EQ(dropped, (std::vector<int>{ 1, 2 }));
+    ASSERT_EQ(batched, (std::vector<std::vector<int>>{ { 1 }, { 2 }, { 3, 4, 5 } }));
+    ASSERT_EQ(stats.delayed(), 3);
+    ASSERT_EQ(stats.dropped(), 3);
+
+    // Completion waits for the delayed values
+    bool hasCompleted = false;
+    RxLite::Subject<int> source;
+    RxLite::Subscription completion = source.pipe(RxLite::rateLimit<int>(100, 1, scheduler))
+        .subscribe(RxLite::Observer<int>([](int) {}, [](const std::exception_ptr&) {}, [&hasCompleted]() { hasCompleted = true; }));
+
+    source.next(1);
+    source.next(2);
+    source.complete();
+    ASSERT_FALSE(hasCompleted);
+    scheduler.advanceBy(std::chrono::milliseconds(10));
+    ASSERT_TRUE(hasCompleted);
+
+    ASSERT_THROW(RxLite::rateLimit<int>(0, 1, scheduler), std::invalid_argument);
+}
+
+TEST(OperatorTestsuite, ReduceTest) {
+    RxLite::Subject<int> subject;
+
+    std::vector<int> sums;
+    std::vector<std::map<int, int>> histograms;
+    std::vector<std::int64_t> batchSums;
+    bool hasCompleted = false;
+
+    RxLite::Subscription sumSubscription = subject.pipe(RxLite::reduce<int>(0, [](int sum, int value) { return sum + value; }))
+        .subscribe(RxLite::Observer<int>(
+            [&sums](int sum) { sums.push_back(sum); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+    RxLite::Subscription histogramSubscription = subject
+        .pipe(RxLite::reduceInPlace<int>(std::map<int, int>(), [](std::map<int, int>& histogram, int value) { histogram[value % 3]++; }))
+        .subscribe([&histograms](const std::map<int, int>& histogram) { histograms.push_back(histogram); });
+    RxLite::Subscription batchSubscription = subject
+        .pipe(RxLite::bufferCount<int>(4))
+        .pipe(RxLite::reduceBatches<std::vector<int>>(std::int64_t(0), [](std::int64_t& sum, std::span<const int> batch) {
+            for (int value : batch) {
+                sum += value;
+            }
+        }))
+        .subscribe([&batchSums](std::int64_t sum) { batchSums.push_back(sum); });
+
+    for (int i = 1; i <= 10; i++) {
+        subject.next(i);
+    }
+
+    // Nothing is emitted before completion
+    ASSERT_TRUE(sums.empty());
+    ASSERT_TRUE(histograms.empty());
+    ASSERT_TRUE(batchSums.empty());
+
+    subject.complete();
+    ASSERT_EQ(sums, std::vector<int>{ 55 });
+    ASSERT_EQ(histograms, (std::vector<std::map<int, int>>{ { { 0, 3 }, { 1, 4 }, { 2, 3 } } }));
+    ASSERT_EQ(batchSums, std::vector<std::int64_t>{ 55 });
+    ASSERT_TRUE(hasCompleted);
+
+    // An empty source reduces to the seed
+    RxLite::Subject<int> emptySubject;
+    std::vector<int> emptySums;
+    RxLite::Subscription emptySubscription = emptySubject.pipe(RxLite::reduce<int>(7, [](int sum, int value) { return sum + value; }))
+        .subscribe([&emptySums](int sum) { emptySums.push_back(sum); });
+    emptySubject.complete();
+    ASSERT_EQ(emptySums, std::vector<int>{ 7 });
+}
+
+TEST(OperatorTestsuite, SampleTimeTest) {
+    RxLite::VirtualTimeScheduler scheduler;
+
+    // Samples at 10ms, 20ms and 30ms; nothing new arrives before the third, 7 is never sampled
+    std::vector<int> results = runTimed(RxLite::sampleTime<int>(std::chrono::milliseconds(10), scheduler), scheduler,
+                                        { { 1, 1 }, { 5, 2 }, { 12, 3 }, { 31, 7 } }, 35);
+    ASSERT_EQ(results, (std::vector<int>{ 2, 3 }));
+}
+
+TEST(OperatorTestsuite, ScanTest) {
+    RxLite::Subject<int> subject;
+
+    std::vector<int> sums;
+    std::vector<std::size_t> sizes;
+    std::vector<const std::vector<int>*> addresses;
+    std::vector<int> batchMaxima;
+    bool hasCompleted = false;
+
+    RxLite::Subscription sumSubscription = subject.pipe(RxLite::scan<int>(0, [](int sum, int value) { return sum + value; }))
+        .subscribe(RxLite::Observer<int>(
+            [&sums](int sum) { sums.push_back(sum); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+    RxLite::Subscription inPlaceSubscription = subject
+        .pipe(RxLite::scanInPlace<int>(std::vector<int>(), [](std::vector<int>& values, int value) { values.push_back(value); }))
+        .subscribe([&sizes, &addresses](const std::vector<int>& values) {
+            sizes.push_back(values.size());
+            addresses.push_back(&values);
+        });
+    RxLite::Subscription batchSubscription = subject
+        .pipe(RxLite::bufferCount<int>(2))
+        .pipe(RxLite::scanBatches<std::vector<int>>(0, [](int& maximum, std::span<const int> batch) {
+            maximum = std::max(maximum, *std::max_element(batch.begin(), batch.end()));
+        }))
+        .subscribe([&batchMaxima](int maximum) { batchMaxima.push_back(maximum); });
+
+    for (int value : { 3, 1, 4, 1, 5 }) {
+        subject.next(value);
+    }
+
+    ASSERT_EQ(sums, (std::vector<int>{ 3, 4, 8, 9, 14 }));
+    ASSERT_EQ(sizes, (std::vector<std::size_t>{ 1, 2, 3, 4, 5 }));
+    ASSERT_EQ(batchMaxima, (std::vector<int>{ 3, 4 }));
+
+    // The in-place accumulator is emitted by reference, never copied
+    ASSERT_TRUE(std::all_of(addresses.begin(), addresses.end(), [&addresses](const auto* address) { return address == addresses.front(); }));
+
+    subject.complete();
+    ASSERT_EQ(batchMaxima, (std::vector<int>{ 3, 4, 5 }));
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(OperatorTestsuite, ShedLoadTest) {
+    RxLite::Subject<int> subject;
+    RxLite::VirtualTimeScheduler scheduler;
+    RxLite::ShedStats stats;
+
+    std::vector<int> results;
+    bool hasCompleted = false;
+
+    // Values of 100 and more are control messages, the others are data
+    RxLite::Subscription subscription = subject
+        .pipe(RxLite::shedLoad<int>([](int value) { return value >= 100 ? 1 : 0; }, 3, scheduler, stats))
+        .subscribe(RxLite::Observer<int>(
+            [&results](int value) { results.push_back(value); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+
+    // Nothing is emitted on the producer's thread
+    for (int value : { 0, 2, 4, 100, 6, 101, 102, 8 }) {
+        subject.next(value);
+    }
+    ASSERT_TRUE(results.empty());
+
+    // Data is shed oldest first, and nothing gives way to a value of lower priority
+    scheduler.flush();
+    ASSERT_EQ(results, (std::vector<int>{ 100, 101, 102 }));
+    ASSERT_EQ(stats.shed(0), 5);
+    ASSERT_EQ(stats.shed(1), 0);
+    ASSERT_EQ(stats.total(), 5);
+
+    // Higher priorities overtake, completion waits for the pending values
+    subject.next(10);
+    subject.next(103);
+    subject.complete();
+    ASSERT_FALSE(hasCompleted);
+
+    scheduler.flush();
+    ASSERT_EQ(results, (std::vector<int>{ 100, 101, 102, 103, 10 }));
+    ASSERT_TRUE(hasCompleted);
+    ASSERT_EQ(stats.byPriority(), (std::map<int, std::uint64_t>{ { 0, 5 } }));
+
+    // An error raised while a value is emitted is delivered after it, discarding the rest, and never followed by completion
+    RxLite::Subject<int> failing;
+    std::vector<int> events;
+    static constexpr int Error = -1;
+    static constexpr int Completion = -2;
+
+    RxLite::Subscription failingSubscription = failing
+        .pipe(RxLite::shedLoad<int>([](int) { return 0; }, 4, scheduler))
+        .subscribe(RxLite::Observer<int>(
+            [&](int value) {
+                events.push_back(value);
+                failing.error(std::make_exception_ptr(std::runtime_error("overloaded")));
+            },
+            [&events](const std::exception_ptr&) { events.push_back(Error); },
+            [&events]() { events.push_back(Completion); }
+        ));
+
+    failing.next(1);
+    failing.next(2);
+    ASSERT_TRUE(events.empty());
+
+    scheduler.flush();
+    ASSERT_EQ(events, (std::vector<int>{ 1, Error }));
+
+    ASSERT_THROW(RxLite::shedLoad<int>([](int) { return 0; }, 0, scheduler), std::invalid_argument);
+}
+
+TEST(OperatorTestsuite, SwitchMapTest) {
+    RxLite::Subject<int> subject;
+    std::vector<RxLite::Subject<int>> inners(2);
+    std::vector<int> results;
+    bool hasCompleted = false;
+
+    RxLite::Subscription subscription = subject
+        .pipe(RxLite::switchMap<int>([&inners](int index) { return RxLite::Observable<int>(inners[index]); }))
+        .subscribe(RxLite::Observer<int>(
+            [&results](int value) { results.push_back(value); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+
+    subject.next(0);
+    inners[0].next(1);
+
+    // The previous inner observable is dropped as soon as the next value arrives
+    subject.next(1);
+    inners[0].next(100);
+    inners[1].next(2);
+
+    subject.complete();
+    ASSERT_FALSE(hasCompleted);
+    inners[1].complete();
+
+    ASSERT_EQ(results, (std::vector<int>{ 1, 2 }));
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(OperatorTestsuite, ThrottleTimeTest) {
+    RxLite::VirtualTimeScheduler scheduler;
+    std::vector<std::pair<int, int>> values = { { 0, 1 }, { 4, 2 }, { 8, 3 }, { 15, 4 }, { 40, 5 } };
+
+    std::vector<int> leading = runTimed(RxLite::throttleTime<int>(std::chrono::milliseconds(10), scheduler), scheduler, values, 60);
+    ASSERT_EQ(leading, (std::vector<int>{ 1, 4, 5 }));
+
+    // The trailing value at 10ms starts the next period, which swallows 4 until 20ms
+    std::vector<int> trailing = runTimed(RxLite::throttleTime<int>(std::chrono::milliseconds(10), scheduler, { .leading = false, .trailing = true }),
+                                         scheduler, values, 60);
+    ASSERT_EQ(trailing, (std::vector<int>{ 3, 4, 5 }));
+
+    std::vector<int> both = runTimed(RxLite::throttleTime<int>(std::chrono::milliseconds(10), scheduler, { .leading = true, .trailing = true }),
+                                     scheduler, values, 60);
+    ASSERT_EQ(both, (std::vector<int>{ 1, 3, 4, 5 }));
+}
+
+// Sums up the values of each window as they arrive
+struct WindowSums {
+    std::vector<int> sums;
+    std::vector<bool> completed;
+    std::vector<RxLite::Subscription> subscriptions;
+
+    void add(const RxLite::Observable<int>& window) {
+        std::size_t index = sums.size();
+        sums.push_back(0);
+        completed.push_back(false);
+
+        subscriptions.push_back(window.subscribe(RxLite::Observer<int>(
+            [this, index](int value) { sums[index] += value; },
+            [](const std::exception_ptr&) {},
+            [this, index]() { completed[index] = true; }
+        )));
+    }
+};
+
+TEST(OperatorTestsuite, WindowCountTest) {
+    RxLite::Subject<int> subject;
+    WindowSums tumbling;
+    WindowSums sliding;
+    std::optional<RxLite::Observable<int>> lastWindow;
+
+    RxLite::Subscription tumblingSubscription = subject.pipe(RxLite::windowCount<int>(2))
+        .subscribe([&](const RxLite::Observable<int>& window) {
+            tumbling.add(window);
+            lastWindow = window;
+        });
+    RxLite::Subscription slidingSubscription = subject.pipe(RxLite::windowCount<int>(3, 1))
+        .subscribe([&sliding](const RxLite::Observable<int>& window) { sliding.add(window); });
+
+    for (int i = 1; i <= 5; i++) {
+        subject.next(i);
+    }
+
+    ASSERT_EQ(tumbling.sums, (std::vector<int>{ 3, 7, 5 }));
+    ASSERT_EQ(tumbling.completed, (std::vector<bool>{ true, true, false }));
+    ASSERT_EQ(sliding.sums, (std::vector<int>{ 6, 9, 12, 9, 5 }));
+
+    subject.complete();
+    ASSERT_EQ(tumbling.completed, (std::vector<bool>{ true, true, true }));
+
+    // Subscribing to a closed window only yields its completion
+    bool hasCompleted = false;
+    RxLite::Subscription late = lastWindow->subscribe(RxLite::Observer<int>(
+        [](int) { FAIL(); },
+        [](const std::exception_ptr&) {},
+        [&hasCompleted]() { hasCompleted = true; }
+    ));
+    ASSERT_TRUE(hasCompleted);
+}
+
+TEST(OperatorTestsuite, WindowReuseTest) {
+    RxLite::Subject<int> subject;
+    std::vector<int> values;
+    RxLite::Subscription stale;
+    RxLite::Subscription current;
+    int windows = 0;
+
+    // The second window reuses the first one, and its subscriber may reuse the first subscriber's memory
+    RxLite::Subscription subscription = subject.pipe(RxLite::windowCount<int>(2))
+        .subscribe([&](const RxLite::Observable<int>& window) {
+            if (windows++ == 0) {
+                stale = window.subscribe([](int) {});
+            } else {
+                current = window.subscribe([&values](int value) { values.push_back(value); });
+            }
+        });
+
+    subject.next(1);
+    subject.next(2);
+    subject.next(3);
+
+    // Unsubscribing from the closed first window leaves the subscribers of the second one alone
+    stale.unsubscribe();
+    subject.next(4);
+    ASSERT_EQ(values, (std::vector<int>{ 3, 4 }));
+}
+
+TEST(OperatorTestsuite, WindowTimeTest) {
+    RxLite::Subject<int> subject;
+    RxLite::VirtualTimeScheduler scheduler;
+    WindowSums tumbling;
+    WindowSums sliding;
+    bool hasCompleted = false;
+
+    RxLite::Subscription tumblingSubscription = subject.pipe(RxLite::windowTime<int>(std::chrono::milliseconds(10), scheduler))
+        .subscribe(RxLite::Observer<RxLite::Observable<int>>(
+            [&tumbling](const RxLite::Observable<int>& window) { tumbling.add(window); },
+            [](const std::exception_ptr&) {},
+            [&hasCompleted]() { hasCompleted = true; }
+        ));
+    RxLite::Subscription slidingSubscription = subject.pipe(RxLite::windowTime<int>(std::chrono::milliseconds(10), scheduler, std::chrono::milliseconds(5)))
+        .subscribe([&sliding](const RxLite::Observable<int>& window) { sliding.add(window); });
+
+    // Values at 0ms, 6ms, 12ms and 30ms
+    subject.next(1);
+    scheduler.advanceBy(std::chrono::milliseconds(6));
+    subject.next(2);
+    scheduler.advanceBy(std::chrono::milliseconds(6));
+    subject.next(4);
+    scheduler.advanceBy(std::chrono::milliseconds(18));
+    subject.next(8);
+
+    // Tumbling windows [0, 10), [10, 20), [20, 30), [30, 40)
+    ASSERT_EQ(tumbling.sums, (std::vector<int>{ 3, 4, 0, 8 }));
+    ASSERT_EQ(tumbling.completed, (std::vector<bool>{ true, true, true, false }));
+
+    // Sliding windows opening every 5ms: [0, 10), [5, 15), [10, 20), ..., [30, 40)
+    ASSERT_EQ(sliding.sums, (std::vector<int>{ 3, 6, 4, 0, 0, 8, 8 }));
+
+    subject.complete();
+    ASSERT_TRUE(tumbling.completed.back());
+    ASSERT_TRUE(hasCompleted);
+}
+
 TEST(OperatorTestsuite, WithLatestFromTest) {
     RxLite::Subject<int> sourceSubject;
     RxLite::Subject<int> latestSubject;
@@ -214,6 +1435,77 @@ TEST(OperatorTestsuite, WithLatestFromTest) {
     ASSERT_EQ(hasCompleted, true);
 }
 
+TEST(OperatorTestsuite, WithLatestFromRefTest) {
+    RxLite::Subject<int> sourceSubject;
+    RxLite::Subject<std::vector<int>> latestSubject;
+
+    std::vector<int> sums;
+    const std::vector<int>* previous = nullptr;
+    bool sameStorage = true;
+
+    // The latest value is handed out by reference, always from the same storage
+    RxLite::Subscription subscription = sourceSubject
+        .pipe(RxLite::withLatestFromRef<int>(RxLite::Observable<std::vector<int>>(latestSubject)))
+        .subscribe([&](const std::tuple<const int&, const std::vector<int>&>& values) {
+            const auto& [value, latest] = values;
+            sums.push_back(value + std::accumulate(latest.begin(), latest.end(), 0));
+
+            sameStorage = sameStorage && (previous == nullptr || previous == &latest);
+            previous = &latest;
+        });
+
+    sourceSubject.next(1);
+    latestSubject.next({ 1, 2 });
+    sourceSubject.next(2);
+    latestSubject.next({ 10, 20 });
+    sourceSubject.next(3);
+
+    ASSERT_EQ(sums, (std::vector<int>{ 5, 33 }));
+    ASSERT_TRUE(sameStorage);
+}
+
+TEST(OperatorTestsuite, WithLatestFromConcurrentTest) {
+    struct Pair {
+        std::int64_t value;
+        std::int64_t doubled;
+    };
+
+    RxLite::Subject<int> sourceSubject;
+    RxLite::Subject<Pair> latestSubject;
+
+    int emitted = 0;
+    bool consistent = true;
+
+    RxLite::Subscription subscription = sourceSubject
+        .pipe(RxLite::withLatestFromConcurrent<int>(RxLite::Observable<Pair>(latestSubject)))
+        .subscribe([&](const std::tuple<int, Pair>& values) {
+            const Pair& pair = std::get<1>(values);
+            consistent = consistent && pair.doubled == 2 * pair.value;
+            emitted++;
+        });
+
+    // Values read while another thread keeps writing are never torn
+    sourceSubject.next(0);
+    latestSubject.next({ 0, 0 });
+
+    std::atomic<bool> stop = false;
+    std::thread writer([&]() {
+        for (std::int64_t i = 1; !stop; i++) {
+            latestSubject.next({ i, 2 * i });
+        }
+    });
+
+    for (int i = 0; i < 100000; i++) {
+        sourceSubject.next(i);
+    }
+
+    stop = true;
+    writer.join();
+
+    ASSERT_EQ(emitted, 100000);
+    ASSERT_TRUE(consistent);
+}
+
 TEST(OperatorTestsuite, CombinedTest) {
     std::vector<size_t> input = { 1, 2, 3, 4, 5 };
     RxLite::Observable<size_t> source = RxLite::Observable<size_t>::from(input);
@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+
+#include <gtest/gtest.h>
+
+#include "RxLite.hpp"
+
+using namespace std::chrono_literals;
+
+static std::set<int> openDescriptors() {
+    std::set<int> fds;
+    for (const auto& entry : std::filesystem::directory_iterator("/proc/self/fd")) {
+        fds.insert(std::stoi(entry.path().filename().string()));
+    }
+
+    return fds;
+}
+
+TEST(ReactorTestsuite, PipeTest) {
+    RxLite::Reactor reactor(4);
+
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::string received;
+    bool hasCompleted = false;
+
+    RxLite::Subscription subscription = reactor.fromFd(fds[0]).subscribe(RxLite::Observer<std::span<const std::byte>>(
+        [&](std::span<const std::byte> chunk) {
+            std::unique_lock lock(mutex);
+            ASSERT_LE(chunk.size(), 4);
+            received.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+        },
+        [](const std::exception_ptr&) {},
+        [&]() {
+            std::unique_lock lock(mutex);
+            hasCompleted = true;
+            done.notify_one();
+        }
+    ));
+
+    std::string message = "hello reactive world";
+    ASSERT_EQ(::write(fds[1], message.data(), message.size()), static_cast<ssize_t>(message.size()));
+    ::close(fds[1]);
+
+    std::unique_lock lock(mutex);
+    ASSERT_TRUE(done.wait_for(lock, 5s, [&]() { return hasCompleted; }));
+    ASSERT_EQ(received, message);
+
+    ::close(fds[0]);
+}
+
+TEST(ReactorTestsuite, SocketpairTest) {
+    constexpr int Pairs = 200;
+    RxLite::Reactor reactor;
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::vector<int> received(Pairs, 0);
+    int total = 0;
+
+    std::vector<std::array<int, 2>> pairs(Pairs);
+    std::vector<RxLite::Subscription> subscriptions;
+    for (int i = 0; i < Pairs; i++) {
+        ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pairs[i].data()), 0);
+        subscriptions.push_back(reactor.fromFd(pairs[i][0]).subscribe([&, i](std::span<const std::byte> chunk) {
+            std::unique_lock lock(mutex);
+            received[i] += static_cast<int>(chunk.size());
+            total += static_cast<int>(chunk.size());
+            done.notify_one();
+        }));
+    }
+
+    // All descriptors are served by the single reactor thread
+    for (int i = 0; i < Pairs; i++) {
+        std::string payload(i + 1, 'x');
+        ASSERT_EQ(::write(pairs[i][1], payload.data(), payload.size()), static_cast<ssize_t>(payload.size()));
+    }
+
+    {
+        std::unique_lock lock(mutex);
+        ASSERT_TRUE(done.wait_for(lock, 5s, [&]() { return total == Pairs * (Pairs + 1) / 2; }));
+        for (int i = 0; i < Pairs; i++) {
+            ASSERT_EQ(received[i], i + 1);
+        }
+    }
+
+    // After unsubscribing, the reactor no longer reads from the descriptor
+    subscriptions[0].unsubscribe();
+    ASSERT_EQ(::write(pairs[0][1], "y", 1), 1);
+
+    std::mutex timerMutex;
+    std::condition_variable timerDone;
+    bool fired = false;
+    reactor.scheduleAfter(10ms, [&]() {
+        std::unique_lock lock(timerMutex);
+        fired = true;
+        timerDone.notify_one();
+    });
+
+    {
+        std::unique_lock lock(timerMutex);
+        ASSERT_TRUE(timerDone.wait_for(lock, 5s, [&]() { return fired; }));
+    }
+
+    {
+        std::unique_lock lock(mutex);
+        ASSERT_EQ(received[0], 1);
+    }
+
+    subscriptions.clear();
+    for (auto& pair : pairs) {
+        ::close(pair[0]);
+        ::close(pair[1]);
+    }
+}
+
+TEST(ReactorTestsuite, WhenReadyTest) {
+    RxLite::Reactor reactor;
+
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::uint32_t events = 0;
+
+    RxLite::Subscription subscription = reactor.whenReady(fds[0], EPOLLIN | EPOLLOUT).subscribe([&](std::uint32_t mask) {
+        std::unique_lock lock(mutex);
+        events |= mask;
+        done.notify_one();
+    });
+
+    ASSERT_EQ(::write(fds[1], "x", 1), 1);
+
+    std::unique_lock lock(mutex);
+    ASSERT_TRUE(done.wait_for(lock, 5s, [&]() { return (events & EPOLLIN) && (events & EPOLLOUT); }));
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST(ReactorTestsuite, UnwatchPendingTest) {
+    RxLite::Reactor reactor;
+
+    // Two descriptors of the same pipe become readable in the same wait of the reactor
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    int readers[2] = { fds[0], ::dup(fds[0]) };
+
+    std::mutex mutex;
+    std::condition_variable done;
+    RxLite::Subscription subscriptions[2];
+    int replacement[2] = { -1, -1 };
+    int deliveries = 0;
+
+    for (int i = 0; i < 2; i++) {
+        subscriptions[i] = reactor.fromFd(readers[i]).subscribe([&, i](std::span<const std::byte>) {
+            std::unique_lock lock(mutex);
+            if (deliveries++ > 0) {
+                return;
+            }
+
+            // Drop the other descriptor before its event is handled, and let a new pipe take its number
+            subscriptions[1 - i].unsubscribe();
+            ::close(readers[1 - i]);
+            readers[1 - i] = -1;
+            ASSERT_EQ(::pipe(replacement), 0);
+            ASSERT_EQ(::write(replacement[1], "x", 1), 1);
+            done.notify_one();
+        });
+    }
+
+    ASSERT_EQ(::write(fds[1], "y", 1), 1);
+
+    {
+        std::unique_lock lock(mutex);
+        ASSERT_TRUE(done.wait_for(lock, 5s, [&]() { return deliveries > 0; }));
+    }
+
+    // Give the reactor time to run the handler of the unwatched descriptor, if it would
+    std::this_thread::sleep_for(50ms);
+
+    std::unique_lock lock(mutex);
+    ASSERT_EQ(deliveries, 1);
+
+    char byte;
+    ::fcntl(replacement[0], F_SETFL, ::fcntl(replacement[0], F_GETFL) | O_NONBLOCK);
+    ASSERT_EQ(::read(replacement[0], &byte, 1), 1);
+
+    for (RxLite::Subscription& subscription : subscriptions) {
+        subscription.unsubscribe();
+    }
+
+    for (int fd : { fds[1], readers[0], readers[1], replacement[0], replacement[1] }) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+TEST(ReactorTestsuite, LastHandleTest) {
+    std::set<int> before = openDescriptors();
+    std::atomic<bool> released = false;
+    std::atomic<bool> ran = false;
+
+    // The only handle is dropped by an action running on the reactor thread itself
+    auto handle = std::make_shared<std::optional<RxLite::Scheduler>>(RxLite::Reactor());
+
+    std::vector<int> reactorFds;
+    std::ranges::set_difference(openDescriptors(), before, std::back_inserter(reactorFds));
+    ASSERT_FALSE(reactorFds.empty());
+
+    auto closed = [&reactorFds]() {
+        return std::ranges::none_of(reactorFds, [](int fd) { return ::fcntl(fd, F_GETFD) != -1; });
+    };
+
+    (*handle)->schedule([&, handle]() {
+        while (!released) {
+            std::this_thread::yield();
+        }
+
+        handle->reset();
+        ran = true;
+    });
+
+    handle.reset();
+    released = true;
+
+    // The epoll instance and the wakeup descriptor are closed once the action returns
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!(ran && closed()) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    ASSERT_TRUE(ran);
+    ASSERT_TRUE(closed());
+}
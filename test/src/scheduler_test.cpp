@@ -0,0 +1,301 @@
+#include <condition_variable>
+
+#include <gtest/gtest.h>
+
+#include "RxLite.hpp"
+
+using namespace std::chrono_literals;
+
+TEST(SchedulerTestsuite, VirtualTimeSchedulerTest) {
+    RxLite::VirtualTimeScheduler scheduler;
+    std::vector<int> order;
+
+    scheduler.scheduleAfter(30ms, [&order]() { order.push_back(3); });
+    scheduler.scheduleAfter(10ms, [&order]() { order.push_back(1); });
+    scheduler.scheduleAfter(20ms, [&order, &scheduler]() {
+        order.push_back(2);
+        scheduler.scheduleAfter(5ms, [&order]() { order.push_back(25); });
+    });
+
+    scheduler.advanceBy(9ms);
+    ASSERT_TRUE(order.empty());
+
+    scheduler.advanceBy(16ms);
+    ASSERT_EQ(order, (std::vector<int>{1, 2, 25}));
+    ASSERT_EQ(scheduler.now().time_since_epoch(), 25ms);
+
+    // Hours of virtual time pass instantly
+    scheduler.advanceBy(24h);
+    ASSERT_EQ(order, (std::vector<int>{1, 2, 25, 3}));
+    ASSERT_EQ(scheduler.now().time_since_epoch(), 24h + 25ms);
+}
+
+TEST(SchedulerTestsuite, TimerTest) {
+    RxLite::VirtualTimeScheduler scheduler;
+    int fired = 0;
+
+    RxLite::Timer cancelled = scheduler.scheduleAfter(10ms, [&fired]() { fired += 1; });
+    RxLite::Timer moved = scheduler.scheduleAfter(10ms, [&fired]() { fired += 10; });
+    ASSERT_TRUE(cancelled.isPending());
+
+    cancelled.cancel();
+    moved.rescheduleAfter(50ms);
+    ASSERT_FALSE(cancelled.isPending());
+
+    scheduler.advanceBy(20ms);
+    ASSERT_EQ(fired, 0);
+
+    scheduler.advanceBy(30ms);
+    ASSERT_EQ(fired, 10);
+    ASSERT_FALSE(moved.isPending());
+
+    // Fired timers can be armed again without creating a new one
+    moved.rescheduleAfter(1ms);
+    scheduler.flush();
+    ASSERT_EQ(fired, 20);
+}
+
+TEST(SchedulerTestsuite, ColdObservableTest) {
+    RxLite::TestScheduler scheduler;
+    std::map<char, int> values = {{'a', 1}, {'b', 2}, {'c', 3}};
+
+    RxLite::Observable<int> cold = scheduler.createColdObservable<int>("-a-b-(c|)", values);
+    auto recorded = scheduler.record(cold);
+
+    scheduler.advanceBy(3ms);
+    ASSERT_EQ(*recorded, scheduler.parseMarbles<int>("-a-b", values));
+
+    scheduler.flush();
+    ASSERT_EQ(*recorded, scheduler.parseMarbles<int>("-a-b-(c|)", values));
+
+    // A late subscriber gets its own playback, shifted by the subscription time
+    auto late = scheduler.record(cold);
+    scheduler.flush();
+    ASSERT_EQ(*late, scheduler.parseMarbles<int>("------a-b-(c|)", values));
+}
+
+TEST(SchedulerTestsuite, HotObservableTest) {
+    RxLite::TestScheduler scheduler;
+    std::map<char, int> values = {{'a', 1}, {'b', 2}, {'c', 3}, {'d', 4}};
+
+    RxLite::Observable<int> hot = scheduler.createHotObservable<int>("a-^-b--c--|", values);
+    RxLite::Observable<int> cold = scheduler.createColdObservable<int>("---d|", values);
+
+    auto early = scheduler.record(hot.pipe(RxLite::merge<int>(cold)));
+    scheduler.advanceBy(4ms);
+    auto late = scheduler.record(hot);
+    scheduler.flush();
+
+    ASSERT_EQ(*early, scheduler.parseMarbles<int>("^-bd-c--|", values));
+    ASSERT_EQ(*late, scheduler.parseMarbles<int>("^----c--|", values));
+}
+
+TEST(SchedulerTestsuite, HeapTimerQueueTest) {
+    using Clock = std::chrono::steady_clock;
+
+    RxLite::HeapTimerQueue heap;
+    std::vector<std::shared_ptr<RxLite::impl::TimerSlot>> slots;
+    std::vector<RxLite::impl::ExpiredTimer> expired;
+
+    auto arm = [&heap](const std::shared_ptr<RxLite::impl::TimerSlot>& slot, Clock::duration delay) {
+        if (slot->armed) {
+            heap.remove(slot);
+        }
+
+        slot->generation++;
+        slot->due = Clock::time_point(delay);
+        slot->armed = true;
+        heap.push(slot, Clock::time_point());
+    };
+
+    for (int i = 0; i < 8; i++) {
+        slots.push_back(std::make_shared<RxLite::impl::TimerSlot>([]() {}));
+        arm(slots.back(), (8 - i) * 10ms);
+    }
+
+    // Moving a timer replaces its entry rather than adding one
+    for (int i = 0; i < 1000; i++) {
+        arm(slots[3], 1h + i * 1ms);
+    }
+    arm(slots[5], 5ms);
+    ASSERT_EQ(heap.size(), slots.size());
+
+    heap.remove(slots[0]);
+    slots[0]->armed = false;
+    ASSERT_EQ(heap.size(), slots.size() - 1);
+    ASSERT_EQ(heap.nextDue(), Clock::time_point(5ms));
+
+    heap.expire(Clock::time_point(2h), expired);
+
+    std::vector<Clock::duration> fired;
+    for (const auto& timer : expired) {
+        fired.push_back(timer.slot->due.time_since_epoch());
+    }
+
+    ASSERT_EQ(fired, (std::vector<Clock::duration>{ 5ms, 10ms, 20ms, 40ms, 60ms, 70ms, 1h + 999ms }));
+    ASSERT_EQ(heap.size(), 0);
+}
+
+TEST(SchedulerTestsuite, TimerWheelTest) {
+    using Clock = std::chrono::steady_clock;
+
+    RxLite::TimerWheel wheel(1ms);
+    std::vector<std::shared_ptr<RxLite::impl::TimerSlot>> slots;
+    std::vector<RxLite::impl::ExpiredTimer> expired;
+
+    // Spread due times over all levels of the wheel, including beyond the outermost one
+    std::vector<Clock::duration> delays = { 0ms, 1ms, 255ms, 256ms, 300ms, 20s, 5min, 20h, 60 * 24h };
+    for (Clock::duration delay : delays) {
+        auto slot = std::make_shared<RxLite::impl::TimerSlot>([]() {});
+        slot->due = Clock::time_point(delay);
+        slot->armed = true;
+        wheel.push(slot, Clock::time_point());
+        slots.push_back(slot);
+    }
+
+    wheel.remove(slots[4]);
+    ASSERT_EQ(wheel.size(), delays.size() - 1);
+
+    std::vector<Clock::duration> fired;
+    for (Clock::time_point now; now <= Clock::time_point(61 * 24h); now += 1min) {
+        wheel.expire(now, expired);
+
+        for (const auto& timer : expired) {
+            ASSERT_LE(timer.slot->due, now);
+            ASSERT_GT(timer.slot->due + 1min, now);
+            fired.push_back(timer.slot->due.time_since_epoch());
+        }
+
+        expired.clear();
+    }
+
+    ASSERT_EQ(fired, (std::vector<Clock::duration>{ 0ms, 1ms, 255ms, 256ms, 20s, 5min, 20h, 60 * 24h }));
+    ASSERT_EQ(wheel.size(), 0);
+}
+
+TEST(SchedulerTestsuite, EventLoopSchedulerTest) {
+    auto runTimers = [](RxLite::Scheduler scheduler) {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::vector<int> order;
+
+        RxLite::Timer cancelled = scheduler.scheduleAfter(5ms, [&]() {
+            std::unique_lock lock(mutex);
+            order.push_back(-1);
+        });
+
+        for (int i = 3; i >= 1; i--) {
+            scheduler.scheduleAfter(i * 10ms, [&, i]() {
+                std::unique_lock lock(mutex);
+                order.push_back(i);
+                done.notify_one();
+            });
+        }
+
+        cancelled.cancel();
+
+        std::unique_lock lock(mutex);
+        done.wait_for(lock, 5s, [&]() { return order.size() == 3; });
+        return order;
+    };
+
+    ASSERT_EQ(runTimers(RxLite::EventLoopScheduler<>()), (std::vector<int>{1, 2, 3}));
+    ASSERT_EQ(runTimers(RxLite::EventLoopScheduler<RxLite::TimerWheel>(100us)), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(SchedulerTestsuite, EventLoopSchedulerLastHandleTest) {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::atomic<bool> released = false;
+    bool ran = false;
+
+    // The only handle is dropped by an action running on the loop itself
+    auto handle = std::make_shared<std::optional<RxLite::Scheduler>>(RxLite::EventLoopScheduler<>());
+    (*handle)->schedule([&, handle]() {
+        while (!released) {
+            std::this_thread::yield();
+        }
+
+        handle->reset();
+
+        std::unique_lock lock(mutex);
+        ran = true;
+        done.notify_one();
+    });
+
+    handle.reset();
+    released = true;
+
+    std::unique_lock lock(mutex);
+    ASSERT_TRUE(done.wait_for(lock, 5s, [&]() { return ran; }));
+}
+
+#if defined(__linux__)
+TEST(SchedulerTestsuite, AffinityTest) {
+    RxLite::Affinity affinity = RxLite::Affinity::node(0);
+    ASSERT_FALSE(affinity.cpus().empty());
+    ASSERT_EQ(affinity.numaNode(), 0);
+    ASSERT_THROW(RxLite::Affinity::node(RxLite::Affinity::MaxNodes), std::invalid_argument);
+    ASSERT_THROW(RxLite::Affinity({ -1 }), std::invalid_argument);
+
+    // The worker thread runs on exactly the requested CPU
+    int cpu = affinity.cpus().front();
+    RxLite::EventLoopScheduler<> scheduler(RxLite::Affinity({ cpu }, 0));
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::optional<cpu_set_t> workerSet;
+
+    scheduler.schedule([&]() {
+        cpu_set_t set;
+        ::pthread_getaffinity_np(::pthread_self(), sizeof(set), &set);
+
+        std::unique_lock lock(mutex);
+        workerSet = set;
+        done.notify_one();
+    });
+
+    std::unique_lock lock(mutex);
+    ASSERT_TRUE(done.wait_for(lock, 5s, [&]() { return workerSet.has_value(); }));
+    ASSERT_EQ(CPU_COUNT(&*workerSet), 1);
+    ASSERT_TRUE(CPU_ISSET(cpu, &*workerSet));
+}
+#endif
+
+TEST(SchedulerTestsuite, TrampolineSchedulerTest) {
+    RxLite::TrampolineScheduler scheduler;
+    std::vector<int> order;
+    int depth = 0;
+    int maxDepth = 0;
+
+    std::function<void(int)> recurse = [&](int i) {
+        depth++;
+        maxDepth = std::max(maxDepth, depth);
+        order.push_back(i);
+
+        if (i < 100000) {
+            scheduler.dispatch([&recurse, i]() { recurse(i + 1); });
+        }
+
+        depth--;
+    };
+
+    scheduler.dispatch([&recurse]() { recurse(1); });
+
+    // Re-entrant work is queued and drained iteratively
+    ASSERT_EQ(order.size(), 100000);
+    ASSERT_EQ(order.back(), 100000);
+    ASSERT_EQ(maxDepth, 1);
+
+    // Queued work runs in order, after the action that scheduled it
+    order.clear();
+    scheduler.dispatch([&]() {
+        scheduler.schedule([&]() { order.push_back(2); });
+        RxLite::Timer cancelled = scheduler.schedule([&]() { order.push_back(-1); });
+        scheduler.scheduleAfter(1ms, [&]() { order.push_back(3); });
+        cancelled.cancel();
+        order.push_back(1);
+    });
+
+    ASSERT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
@@ -1,7 +1,12 @@
+#include <condition_variable>
+#include <thread>
+
 #include <gtest/gtest.h>
 
 #include "RxLite.hpp"
 
+using namespace std::chrono_literals;
+
 TEST(SubjectTestsuite, SubjectTest) {
     RxLite::Subject<int> subject;
     std::vector<RxLite::Subscription> subscriptions;
@@ -30,6 +35,96 @@ TEST(SubjectTestsuite, SubjectTest) {
     ASSERT_EQ(sum, expectedSum);
 }
 
+TEST(SubjectTestsuite, SubjectSubscribeOnCompleteTest) {
+    RxLite::Subject<int> subject;
+    RxLite::Subscription late;
+    bool lateCompleted = false;
+
+    // Subscribing while the subject completes still yields the completion
+    RxLite::Subscription subscription = subject.subscribe(RxLite::Observer<int>(
+        [](int) {},
+        [](const std::exception_ptr&) {},
+        [&]() {
+            late = subject.subscribe(RxLite::Observer<int>(
+                [](int) { FAIL(); },
+                [](const std::exception_ptr&) {},
+                [&lateCompleted]() { lateCompleted = true; }
+            ));
+        }
+    ));
+
+    subject.complete();
+    ASSERT_TRUE(lateCompleted);
+
+    subject.next(1);
+}
+
+TEST(SubjectTestsuite, SubjectDeliveryTest) {
+    RxLite::EventLoopScheduler<> scheduler;
+    RxLite::Subject<int> subject(scheduler);
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::vector<int> results;
+    std::thread::id deliveryThread;
+    bool hasCompleted = false;
+
+    RxLite::Subscription subscription = subject.subscribe(RxLite::Observer<int>(
+        [&](int value) {
+            std::unique_lock lock(mutex);
+            results.push_back(value);
+            deliveryThread = std::this_thread::get_id();
+        },
+        [](const std::exception_ptr&) {},
+        [&]() {
+            std::unique_lock lock(mutex);
+            hasCompleted = true;
+            done.notify_one();
+        }
+    ));
+
+    for (int i = 1; i <= 100; i++) {
+        subject.next(i);
+    }
+
+    subject.complete();
+
+    std::unique_lock lock(mutex);
+    ASSERT_TRUE(done.wait_for(lock, 5s, [&]() { return hasCompleted; }));
+    ASSERT_EQ(results.size(), 100);
+    ASSERT_TRUE(std::is_sorted(results.begin(), results.end()));
+    ASSERT_NE(deliveryThread, std::this_thread::get_id());
+}
+
+TEST(SubjectTestsuite, SubjectDeliveryLifetimeTest) {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::atomic<bool> released = false;
+    bool delivered = false;
+
+    RxLite::Subscription subscription;
+    {
+        // The pending delivery holds the last handle of the scheduler once the subject is gone
+        RxLite::Subject<int> subject{ RxLite::Scheduler(RxLite::EventLoopScheduler<>()) };
+        subscription = subject.subscribe([&](int) {
+            while (!released) {
+                std::this_thread::yield();
+            }
+
+            std::unique_lock lock(mutex);
+            delivered = true;
+            done.notify_one();
+        });
+
+        subject.next(1);
+    }
+
+    released = true;
+
+    std::unique_lock lock(mutex);
+    ASSERT_TRUE(done.wait_for(lock, 5s, [&]() { return delivered; }));
+}
+
 TEST(SubjectTestsuite, BehaviorSubjectTest) {
     RxLite::BehaviorSubject<int> subject(0);
     std::vector<RxLite::Subscription> subscriptions;